@@ -23,6 +23,7 @@
 #include <Ark/Compiler/AST/Parser.hpp>
 #include <Ark/Compiler/AST/Optimizer.hpp>
 #include <Ark/Compiler/ValTableElem.hpp>
+#include <Ark/Compiler/FunctionInfo.hpp>
 
 namespace Ark
 {
@@ -84,6 +85,9 @@ namespace Ark
         std::vector<internal::ValTableElem> m_values;
         std::vector<std::vector<uint8_t>> m_code_pages;
         std::vector<std::vector<uint8_t>> m_temp_pages;  ///< we need temporary code pages for some compilations passes
+        std::vector<internal::FunctionInfo> m_functions;  ///< metadata of each code page (name, arity, local variables...)
+        std::size_t m_frame_page;                         ///< page of the function being compiled, owning the local variables
+        uint16_t m_function_name;                         ///< symbol id of the variable the next compiled function is bound to
 
         bytecode_t m_bytecode;
         unsigned m_debug;  ///< the debug level of the compiler
@@ -210,12 +214,13 @@ namespace Ark
          * 
          * @param x the internal::Node to compile
          * @param p the current page number we're on
+         * @param is_terminal true if the node is in tail position in a function, its value being returned
          */
-        void _compile(const internal::Node& x, int p);
+        void _compile(const internal::Node& x, int p, bool is_terminal = false);
 
         void compileSymbol(const internal::Node& x, int p);
         void compileSpecific(const internal::Node& c0, const internal::Node& x, int p);
-        void compileIf(const internal::Node& x, int p);
+        void compileIf(const internal::Node& x, int p, bool is_terminal);
         void compileFunction(const internal::Node& x, int p);
         void compileLetMut(internal::Keyword n, const internal::Node& x, int p);
         void compileWhile(const internal::Node& x, int p);
@@ -223,7 +228,48 @@ namespace Ark
         void compileQuote(const internal::Node& x, int p);
         void compilePluginImport(const internal::Node& x, int p);
         void compileDel(const internal::Node& x, int p);
-        void handleCalls(const internal::Node& x, int p);
+        void handleCalls(const internal::Node& x, int p, bool is_terminal);
+
+        /**
+         * @brief Register the variables created with let and mut in a function body, without entering nested functions
+         * 
+         * @param x the node to search into
+         * @param layout the local variables of the function, in slot order
+         */
+        void collectLocals(const internal::Node& x, std::vector<uint16_t>& layout);
+
+        /**
+         * @brief Add a variable to the local variables of a function, if it isn't already there
+         * 
+         * @param sym the variable name
+         * @param layout the local variables of the function, in slot order
+         */
+        void addLocal(const internal::Node& sym, std::vector<uint16_t>& layout);
+
+        /**
+         * @brief Get the slot of a variable in the frame of the function being compiled
+         * 
+         * @param id symbol id of the variable
+         * @return std::optional<uint16_t> the slot, or nothing if it isn't a local variable
+         */
+        std::optional<uint16_t> localSlot(uint16_t id) noexcept;
+
+        /**
+         * @brief Use the name of a variable as the name of the function it is being bound to, if any
+         * 
+         * @param x a (let|mut|set variable ...) node
+         * @param id symbol id of the variable
+         */
+        void nameFunction(const internal::Node& x, uint16_t id) noexcept;
+
+        /**
+         * @brief Compute the maximum number of values a code page can put on the stack
+         * 
+         * @param page the code page, with the jumps addresses not yet translated
+         * @param initial number of values already on the stack when entering the page
+         * @return uint16_t 
+         */
+        uint16_t computeMaxStack(const std::vector<uint8_t>& page, uint16_t initial) noexcept;
 
         /**
          * @brief Put a value in the bytecode, handling the closures chains
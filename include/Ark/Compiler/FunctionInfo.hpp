@@ -0,0 +1,39 @@
+/**
+ * @file FunctionInfo.hpp
+ * @author agent (agent@local)
+ * @brief Metadata of a code page, stored in the functions table of the bytecode
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef ARK_COMPILER_FUNCTIONINFO_HPP
+#define ARK_COMPILER_FUNCTIONINFO_HPP
+
+#include <vector>
+#include <cinttypes>
+
+namespace Ark::internal
+{
+    /**
+     * @brief Describe the code page of a function (or the global page, or quoted code)
+     *
+     * @details Computed by the compiler, and loaded by the State so that the virtual machine
+     * can check calls and size the frames without looking at the code itself.
+     *
+     */
+    struct FunctionInfo
+    {
+        /// Name id used when a function wasn't directly bound to a variable
+        static constexpr uint16_t NoName = 0xffff;
+
+        uint16_t name = NoName;        ///< Symbol id of the variable the function was defined with
+        uint16_t arity = 0;            ///< Number of arguments needed
+        uint16_t max_stack = 0;        ///< Maximum number of values the page puts on the stack, return address included
+        std::vector<uint16_t> locals;  ///< Symbol id of each local variable slot
+    };
+}
+
+#endif
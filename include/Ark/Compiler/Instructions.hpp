@@ -33,6 +33,7 @@ namespace Ark::internal
         STRING_TYPE = 0x02,
         FUNC_TYPE = 0x03,
         CODE_SEGMENT_START = 0x03,
+        FUNCTIONS_TABLE_START = 0x04,
 
         FIRST_COMMAND = 0x01,
         LOAD_SYMBOL = 0x01,
@@ -59,7 +60,12 @@ namespace Ark::internal
         CONCAT_IN_PLACE = 0x16,
         POP_LIST = 0x17,
         POP_LIST_IN_PLACE = 0x18,
-        LAST_COMMAND = 0x18,
+        LOAD_LOCAL = 0x19,
+        STORE_LOCAL = 0x1a,
+        SET_LOCAL = 0x1b,
+        LET_LOCAL = 0x1c,
+        TAIL_CALL = 0x1d,
+        LAST_COMMAND = 0x1d,
 
         FIRST_OPERATOR = 0x20,
         ADD = 0x20,
@@ -89,8 +95,31 @@ namespace Ark::internal
         NOT = 0x38,
         LAST_OPERATOR = 0x38,
 
-        LAST_INSTRUCTION = 0x38
+        LAST_INSTRUCTION = 0x38,
+
+        // superinstructions, created by the State when decoding the code pages, never found in the bytecode
+        FIRST_FUSED = 0x40,
+        LOAD_LOAD_OP = 0x40,        ///< load 2 operands and apply a binary operator
+        LOAD_LOAD_OP_STORE = 0x41,  ///< same, and store the result in a variable, eg (set i (+ i 1))
+        LOAD_LOAD_CMP_JUMP = 0x42,  ///< load 2 operands, compare them and jump following the result
+        CALL_BUILTIN = 0x43,        ///< call a builtin function without loading it on the stack
+        LAST_FUSED = 0x43
     };
+
+    /**
+     * @brief Check if an instruction of the bytecode is followed by a 2 bytes big endian argument
+     * @details Used by the compiler and the state, which must agree on the width of each instruction
+     * 
+     * @param inst the instruction
+     * @return true 
+     * @return false 
+     */
+    constexpr bool hasArgument(uint8_t inst) noexcept
+    {
+        return inst >= Instruction::FIRST_COMMAND && inst <= Instruction::LAST_COMMAND &&
+            inst != Instruction::RET && inst != Instruction::HALT && inst != Instruction::SAVE_ENV &&
+            inst != Instruction::POP_LIST && inst != Instruction::POP_LIST_IN_PLACE;
+    }
 }
 
 #endif
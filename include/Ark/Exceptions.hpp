@@ -41,11 +41,22 @@ namespace Ark
         BetterTypeError& withArg(std::string_view arg_name, ValueType arg_type);
         BetterTypeError& withArg(std::string_view arg_name, const std::vector<ValueType>& arg_type);
 
+        /**
+         * @brief Get the message of the error, describing each argument given with withArg
+         * 
+         * @return const char* 
+         */
+        const char* what() const noexcept override
+        {
+            return m_message.c_str();
+        }
+
     protected:
         std::string_view m_funcname;
         std::size_t m_arg_index;
         std::size_t m_expected_argc;
         std::vector<Value> m_args;
+        std::string m_message;
     };
 
     /**
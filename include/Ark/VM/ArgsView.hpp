@@ -0,0 +1,121 @@
+/**
+ * @file ArgsView.hpp
+ * @author agent (agent@local)
+ * @brief View on the arguments of a C++ function, stored on the stack of the virtual machine
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef ARK_VM_ARGSVIEW_HPP
+#define ARK_VM_ARGSVIEW_HPP
+
+#include <vector>
+#include <cinttypes>
+
+#include <Ark/VM/Value.hpp>
+
+namespace Ark
+{
+    /**
+     * @brief Arguments given to a C++ function (builtins, modules and functions loaded in the State)
+     * @details The arguments aren't copied out of the stack of the virtual machine: some of them are
+     *          references to variables, which are resolved when reading them, the other ones are
+     *          temporary values owned by the stack, which can be moved out with take().
+     *
+     */
+    class ArgsView
+    {
+    public:
+        /**
+         * @brief Construct a new ArgsView object
+         *
+         * @param first pointer to the first argument
+         * @param count number of arguments
+         */
+        ArgsView(Value* first, std::size_t count) noexcept :
+            m_first(first), m_size(count)
+        {}
+
+        /**
+         * @brief Number of arguments
+         *
+         * @return std::size_t
+         */
+        inline std::size_t size() const noexcept
+        {
+            return m_size;
+        }
+
+        /**
+         * @brief Check if there are no arguments
+         *
+         * @return true
+         * @return false
+         */
+        inline bool empty() const noexcept
+        {
+            return m_size == 0;
+        }
+
+        /**
+         * @brief Read an argument, resolving the references to variables
+         *
+         * @param i index of the argument, must be smaller than size()
+         * @return const Value&
+         */
+        inline const Value& operator[](std::size_t i) const noexcept
+        {
+            const Value& arg = m_first[i];
+            return arg.valueType() == ValueType::Reference ? *arg.reference() : arg;
+        }
+
+        /**
+         * @brief Check if an argument is a temporary value owned by the stack, which can be taken without copying it
+         *
+         * @param i index of the argument, must be smaller than size()
+         * @return true
+         * @return false
+         */
+        inline bool owned(std::size_t i) const noexcept
+        {
+            return m_first[i].valueType() != ValueType::Reference;
+        }
+
+        /**
+         * @brief Get an argument to modify it, moving it out of the stack if possible, copying it otherwise
+         * @details An argument can be taken only once
+         *
+         * @param i index of the argument, must be smaller than size()
+         * @return Value
+         */
+        inline Value take(std::size_t i) const noexcept
+        {
+            if (owned(i))
+                return std::move(m_first[i]);
+            return *m_first[i].reference();
+        }
+
+        /**
+         * @brief Take all the arguments, to give them to the old style functions using a vector
+         *
+         * @return std::vector<Value>
+         */
+        inline std::vector<Value> toVector() const
+        {
+            std::vector<Value> args;
+            args.reserve(m_size);
+            for (std::size_t i = 0; i < m_size; ++i)
+                args.push_back(take(i));
+            return args;
+        }
+
+    private:
+        Value* m_first;
+        std::size_t m_size;
+    };
+}
+
+#endif
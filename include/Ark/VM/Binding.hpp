@@ -0,0 +1,219 @@
+/**
+ * @file Binding.hpp
+ * @author agent (agent@local)
+ * @brief Generate the ArkScript wrapper of an ordinary C++ function at compile time, used by State::bind
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef ARK_VM_BINDING_HPP
+#define ARK_VM_BINDING_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <tuple>
+#include <utility>
+#include <type_traits>
+#include <limits>
+#include <cmath>
+
+#include <Ark/VM/Value.hpp>
+#include <Ark/VM/ArgsView.hpp>
+#include <Ark/Builtins/Builtins.hpp>
+#include <Ark/Exceptions.hpp>
+
+namespace Ark
+{
+    class VM;
+}
+
+namespace Ark::internal
+{
+    /**
+     * @brief Conversion between ArkScript values and a C++ type, used by the bound functions
+     * @details Each specialization gives the ArkScript types accepted for the C++ type, a way to read
+     *          the C++ value out of an ArkScript value (without copy when possible), and a way to make
+     *          an ArkScript value out of a C++ one, for the returned values.
+     *
+     * @tparam T the C++ type, without reference nor const qualifier
+     */
+    template <typename T, typename = void>
+    struct Converter
+    {
+        static_assert(sizeof(T) == 0, "this type can not be converted from or to an ArkScript value");
+    };
+
+    template <typename T>
+    struct Converter<T, std::enable_if_t<std::is_arithmetic_v<T> && !std::is_same_v<T, bool>>>
+    {
+        static inline std::vector<ValueType> types() { return { ValueType::Number }; }
+        static inline T from(const Value& value) { return static_cast<T>(value.number()); }
+        static inline Value to(T value) { return Value(static_cast<double>(value)); }
+
+        /**
+         * @brief Check that the value is a number which can be converted to T
+         * @details Converting a number out of the range of T is undefined, and converting a
+         *          non integral number to an integer type would truncate it silently
+         *
+         * @param value
+         * @return true
+         * @return false
+         */
+        static inline bool accepts(const Value& value) noexcept
+        {
+            if (value.valueType() != ValueType::Number)
+                return false;
+
+            double number = value.number();
+            if constexpr (std::is_integral_v<T>)
+                // the bounds are powers of 2, thus exact as double
+                return std::trunc(number) == number && number >= static_cast<double>(std::numeric_limits<T>::min()) &&
+                    number < std::ldexp(1.0, std::numeric_limits<T>::digits);
+            else
+                return !std::isfinite(number) || std::abs(number) <= static_cast<double>(std::numeric_limits<T>::max());
+        }
+    };
+
+    template <>
+    struct Converter<bool>
+    {
+        static inline std::vector<ValueType> types() { return { ValueType::True }; }  // both are named Bool
+        static inline bool accepts(const Value& value) noexcept { return value.valueType() == ValueType::True || value.valueType() == ValueType::False; }
+        static inline bool from(const Value& value) { return value.valueType() == ValueType::True; }
+        static inline Value to(bool value) { return value ? Builtins::trueSym : Builtins::falseSym; }
+    };
+
+    template <>
+    struct Converter<String>
+    {
+        static inline std::vector<ValueType> types() { return { ValueType::String }; }
+        static inline bool accepts(const Value& value) noexcept { return value.valueType() == ValueType::String; }
+        static inline const String& from(const Value& value) { return value.string(); }
+        static inline Value to(const String& value) { return Value(value); }
+    };
+
+    template <>
+    struct Converter<std::string_view>
+    {
+        static inline std::vector<ValueType> types() { return { ValueType::String }; }
+        static inline bool accepts(const Value& value) noexcept { return value.valueType() == ValueType::String; }
+        static inline std::string_view from(const Value& value) { return std::string_view(value.string().c_str(), value.string().size()); }
+        static inline Value to(std::string_view value) { return Value(std::string(value)); }
+    };
+
+    template <>
+    struct Converter<std::string>
+    {
+        static inline std::vector<ValueType> types() { return { ValueType::String }; }
+        static inline bool accepts(const Value& value) noexcept { return value.valueType() == ValueType::String; }
+        static inline std::string from(const Value& value) { return value.string().toString(); }
+        static inline Value to(const std::string& value) { return Value(value); }
+    };
+
+    template <>
+    struct Converter<std::vector<Value>>
+    {
+        static inline std::vector<ValueType> types() { return { ValueType::List }; }
+        static inline bool accepts(const Value& value) noexcept { return value.valueType() == ValueType::List; }
+        static inline std::vector<Value> from(const Value& value) { return value.constList().toVector(); }
+        static inline Value to(std::vector<Value> value) { return Value(std::move(value)); }
+    };
+
+    template <>
+    struct Converter<Value>
+    {
+        static inline std::vector<ValueType> types() { return {}; }
+        static inline bool accepts(const Value&) noexcept { return true; }
+        static inline const Value& from(const Value& value) { return value; }
+        static inline Value to(Value value) { return value; }
+    };
+
+    /**
+     * @brief ArkScript wrapper of a C++ function, checking and unboxing its arguments
+     * @details The function can take numbers (integers only receive integral numbers in their range), bool, std::string, std::string_view, String, std::vector<Value>
+     *          and Value, by value or by const reference, and an optional Ark::VM* as its last argument. It can
+     *          return void (nil in ArkScript) or any of those types but std::string_view.
+     *
+     * @tparam Function pointer to the C++ function
+     */
+    template <auto Function, typename = decltype(Function)>
+    struct Binding
+    {
+        static_assert(sizeof(decltype(Function)) == 0, "only functions can be bound, given as a pointer to a function");
+    };
+
+    template <auto Function, typename Result, typename... Args>
+    struct Binding<Function, Result (*)(Args...)>
+    {
+        using Arguments = std::tuple<Args...>;
+
+        static constexpr bool TakesVM = sizeof...(Args) > 0 && std::is_same_v<std::tuple_element_t<sizeof...(Args) - 1, Arguments>, VM*>;
+        static constexpr std::size_t Arity = sizeof...(Args) - (TakesVM ? 1 : 0);
+
+        template <std::size_t I>
+        using ConverterOf = Converter<std::remove_cv_t<std::remove_reference_t<std::tuple_element_t<I, Arguments>>>>;
+
+        static inline std::string name;  ///< Name given to the function in ArkScript, for the error messages
+
+        /**
+         * @brief Function given to the virtual machine
+         *
+         * @param args the arguments, read without copy
+         * @param vm the virtual machine, given to the function if it takes one
+         * @return Value the converted result of the function
+         */
+        static Value call(ArgsView args, VM* vm)
+        {
+            return invoke(args, vm, std::make_index_sequence<Arity> {});
+        }
+
+    private:
+        template <std::size_t... Is>
+        static Value invoke(ArgsView args, [[maybe_unused]] VM* vm, std::index_sequence<Is...> indices)
+        {
+            static_assert(((!std::is_lvalue_reference_v<std::tuple_element_t<Is, Arguments>> ||
+                            std::is_const_v<std::remove_reference_t<std::tuple_element_t<Is, Arguments>>>) &&
+                           ...),
+                          "the arguments of a bound function must be taken by value or by const reference");
+
+            if (args.size() != Arity || !(ConverterOf<Is>::accepts(args[Is]) && ...))
+                throwTypeError(args, indices);
+
+            if constexpr (std::is_void_v<Result>)
+            {
+                if constexpr (TakesVM)
+                    Function(ConverterOf<Is>::from(args[Is])..., vm);
+                else
+                    Function(ConverterOf<Is>::from(args[Is])...);
+                return Builtins::nil;
+            }
+            else
+            {
+                using ResultConverter = Converter<std::remove_cv_t<std::remove_reference_t<Result>>>;
+
+                if constexpr (TakesVM)
+                    return ResultConverter::to(Function(ConverterOf<Is>::from(args[Is])..., vm));
+                else
+                    return ResultConverter::to(Function(ConverterOf<Is>::from(args[Is])...));
+            }
+        }
+
+        template <std::size_t... Is>
+        [[noreturn]] static void throwTypeError(ArgsView args, std::index_sequence<Is...>)
+        {
+            BetterTypeError error(name, Arity, args.toVector());
+            (error.withArg("arg" + std::to_string(Is + 1), ConverterOf<Is>::types()), ...);
+            throw error;
+        }
+    };
+
+    template <auto Function, typename Result, typename... Args>
+    struct Binding<Function, Result (*)(Args...) noexcept> : Binding<static_cast<Result (*)(Args...)>(Function)>
+    {};
+}
+
+#endif
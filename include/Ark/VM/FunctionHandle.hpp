@@ -0,0 +1,79 @@
+/**
+ * @file FunctionHandle.hpp
+ * @author agent (agent@local)
+ * @brief ArkScript function found by name once, to be called many times from C++, and results of such calls
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef ARK_VM_FUNCTIONHANDLE_HPP
+#define ARK_VM_FUNCTIONHANDLE_HPP
+
+#include <string>
+#include <optional>
+#include <cinttypes>
+
+#include <Ark/VM/Value.hpp>
+
+namespace Ark
+{
+    class VM;
+
+    /**
+     * @brief Result of one of the calls made by VM::callBatch
+     *
+     */
+    struct CallResult
+    {
+        Value value;                       ///< Value returned by the function, nil if the call failed
+        std::optional<std::string> error;  ///< Message of the error raised by the call, if any
+
+        /**
+         * @brief Check if the call succeeded
+         *
+         * @return true
+         * @return false
+         */
+        inline bool ok() const noexcept
+        {
+            return !error.has_value();
+        }
+    };
+
+    /**
+     * @brief ArkScript function of a virtual machine, given by VM::function(name)
+     * @details Calling a function through its handle doesn't search for its name. The handle holds the function
+     *          it was created with, even if the variable is modified later, and can only be used with the
+     *          virtual machine which created it.
+     *
+     */
+    class FunctionHandle
+    {
+    public:
+        /**
+         * @brief Get the function
+         *
+         * @return const Value& a PageAddr or a Closure
+         */
+        inline const Value& value() const noexcept
+        {
+            return m_function;
+        }
+
+        friend class VM;
+
+    private:
+        const VM* m_vm;
+        Value m_function;
+        uint16_t m_id;  ///< Symbol id of the function
+
+        FunctionHandle(const VM* vm, const Value& function, uint16_t id) noexcept :
+            m_vm(vm), m_function(function), m_id(id)
+        {}
+    };
+}
+
+#endif
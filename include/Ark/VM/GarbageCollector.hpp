@@ -0,0 +1,162 @@
+/**
+ * @file GarbageCollector.hpp
+ * @author agent (agent@local)
+ * @brief Collector of the reference cycles made by the closures
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef ARK_VM_GARBAGECOLLECTOR_HPP
+#define ARK_VM_GARBAGECOLLECTOR_HPP
+
+#include <vector>
+#include <memory>
+#include <cinttypes>
+
+#include <Ark/VM/Value.hpp>
+#include <Ark/VM/Scope.hpp>
+
+namespace Ark
+{
+    constexpr std::size_t ArkGCThreshold = 1000;  ///< Default number of closures created between two collections
+
+    /**
+     * @brief Statistics of the garbage collector of a virtual machine
+     *
+     */
+    struct GCStats
+    {
+        std::size_t collections = 0;  ///< Number of collections run
+        std::size_t tracked = 0;      ///< Number of closure environments which may be part of a cycle
+        std::size_t freed = 0;        ///< Number of environments freed by the collector, since the creation of the VM
+        std::size_t threshold = 0;    ///< Number of closures to create before the next collection
+        std::size_t limit = 0;        ///< Maximum number of environments alive, 0 if unlimited
+    };
+
+    namespace internal
+    {
+        /**
+         * @brief Collector of the reference cycles made by the closures
+         * @details The values are reference counted, thus most of them are freed as soon as they aren't used anymore.
+         *          But a closure stored in its own environment (directly, in a list, or through other closures) keeps
+         *          this environment alive forever. The collector keeps track of the environments of the closures,
+         *          and periodically looks for those which are only referenced by each other: it subtracts the references
+         *          coming from the tracked environments (and the closures and lists they hold) to the reference counters,
+         *          and frees the environments which aren't reachable from the remaining references, held by the VM
+         *          (stack, scopes, constants) or the C++ code.
+         *
+         */
+        class GarbageCollector
+        {
+        public:
+            /**
+             * @brief Construct a new GarbageCollector object
+             *
+             */
+            GarbageCollector() noexcept;
+
+            /**
+             * @brief Keep track of the environment of a new closure
+             *
+             * @param scope
+             */
+            inline void track(const Scope_t& scope)
+            {
+                m_tracked.emplace_back(scope);
+                ++m_created;
+            }
+
+            /**
+             * @brief Check if enough closures were created since the last collection to run a new one
+             *
+             * @return true
+             * @return false
+             */
+            inline bool shouldCollect() const noexcept
+            {
+                return m_created >= m_stats.threshold || (m_stats.limit != 0 && m_stats.tracked + m_created > m_stats.limit);
+            }
+
+            /**
+             * @brief Check if more environments than the limit are still alive after a collection
+             *
+             * @return true
+             * @return false
+             */
+            inline bool overLimit() const noexcept
+            {
+                return m_stats.limit != 0 && m_stats.tracked > m_stats.limit;
+            }
+
+            /**
+             * @brief Free the environments which are only referenced by reference cycles
+             *
+             * @param stack values on the stack of the VM, whose references to variables keep the scopes alive
+             * @param size number of values on the stack
+             * @return std::size_t number of environments freed
+             */
+            std::size_t collect(const Value* stack, std::size_t size);
+
+            /**
+             * @brief Set the minimum number of closures created between two collections
+             * @details The threshold grows with the number of environments surviving a collection, so that the
+             *          collections stay proportional to the number of closures created
+             *
+             * @param threshold
+             */
+            void setThreshold(std::size_t threshold) noexcept;
+
+            /**
+             * @brief Get the minimum number of closures created between two collections, as given to setThreshold
+             *
+             * @return std::size_t
+             */
+            inline std::size_t threshold() const noexcept
+            {
+                return m_threshold;
+            }
+
+            /**
+             * @brief Set the maximum number of closure environments alive, 0 for no limit
+             *
+             * @param limit
+             */
+            void setLimit(std::size_t limit) noexcept;
+
+            /**
+             * @brief Get the statistics of the collector
+             *
+             * @return const GCStats&
+             */
+            inline const GCStats& stats() const noexcept
+            {
+                return m_stats;
+            }
+
+        private:
+            struct Node;
+            class Graph;
+
+            std::vector<std::weak_ptr<Scope>> m_tracked;
+            std::size_t m_created;    ///< Number of closures created since the last collection
+            std::size_t m_threshold;  ///< Minimum number of closures created between two collections
+            GCStats m_stats;
+
+            static inline std::vector<Scope::Binding>& bindings(Scope& scope) noexcept
+            {
+                return scope.m_data;
+            }
+
+            template <typename T>
+            static inline ValueBox<T>* box(const Value& value) noexcept
+            {
+                return value.payloadAs<ValueBox<T>>();
+            }
+        };
+    }
+}
+
+#endif
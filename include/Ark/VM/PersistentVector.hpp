@@ -0,0 +1,283 @@
+/**
+ * @file PersistentVector.hpp
+ * @author agent (agent@local)
+ * @brief Persistent vector used to hold the big lists, and the storage of the lists
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef ARK_VM_PERSISTENTVECTOR_HPP
+#define ARK_VM_PERSISTENTVECTOR_HPP
+
+#include <vector>
+#include <memory>
+#include <iterator>
+#include <cinttypes>
+
+namespace Ark
+{
+    class Value;
+
+    /// Number of elements from which a list copied to be modified uses the persistent representation
+    constexpr std::size_t ArkPersistentListThreshold = 64;
+
+    namespace internal
+    {
+        /**
+         * @brief Vector of values whose copies share their elements
+         * @details Radix balanced tree with 32 children per node, holding the elements in its leaves.
+         *          A node shared by multiple vectors is copied when one of them modifies it, thus
+         *          copying a vector is O(1), and reading, setting, adding or removing the last element
+         *          are O(log32 n). Removing the first element only moves the beginning of the vector,
+         *          the elements before it are dropped once they outnumber the remaining ones.
+         *
+         */
+        class PersistentVector
+        {
+        public:
+            static constexpr unsigned Bits = 5;
+            static constexpr std::size_t Width = 1 << Bits;  ///< Number of children of a node
+            static constexpr std::size_t Mask = Width - 1;
+
+            /**
+             * @brief Construct a new empty PersistentVector object
+             *
+             */
+            PersistentVector() noexcept;
+
+            /**
+             * @brief Construct a new PersistentVector object holding a copy of the given values
+             *
+             * @param values
+             */
+            explicit PersistentVector(const std::vector<Value>& values);
+
+            /**
+             * @brief Number of elements
+             *
+             * @return std::size_t
+             */
+            inline std::size_t size() const noexcept
+            {
+                return m_end - m_begin;
+            }
+
+            /**
+             * @brief Read an element
+             *
+             * @param i index of the element, must be smaller than size()
+             * @return const Value&
+             */
+            const Value& operator[](std::size_t i) const noexcept;
+
+            /**
+             * @brief Replace an element
+             *
+             * @param i index of the element, must be smaller than size()
+             * @param value
+             */
+            void set(std::size_t i, Value&& value);
+
+            /**
+             * @brief Add an element at the end
+             *
+             * @param value
+             */
+            void push_back(Value&& value);
+
+            /**
+             * @brief Remove the last element, the vector must not be empty
+             * @details The element is released right away, copying its leaf if it is shared
+             *
+             */
+            void pop_back();
+
+            /**
+             * @brief Remove the first element, the vector must not be empty
+             *
+             */
+            void pop_front();
+
+            /**
+             * @brief Copy the elements in a std::vector
+             *
+             * @return std::vector<Value>
+             */
+            std::vector<Value> toVector() const;
+
+        private:
+            struct Node;
+            struct Branch;
+            struct Leaf;
+
+            std::shared_ptr<Node> m_root;
+            unsigned m_shift;     ///< Number of bits of an index used by the nodes under the root
+            std::size_t m_begin;  ///< Position of the first element in the tree
+            std::size_t m_end;    ///< Position after the last element in the tree
+
+            /**
+             * @brief Get a slot of the tree to modify it, copying the shared nodes on its path and creating the missing ones
+             *
+             * @param position position in the tree, growing it if needed
+             * @return Value&
+             */
+            Value& slot(std::size_t position);
+
+            /**
+             * @brief Find the leaf holding a position of the tree
+             *
+             * @param position
+             * @return const Leaf&
+             */
+            const Leaf& leafFor(std::size_t position) const noexcept;
+        };
+
+        /**
+         * @brief Elements of a list, held by a std::vector or by a PersistentVector
+         * @details Lists are created as std::vector. A big list copied to be modified, or whose first element is removed,
+         *          switches to the persistent representation to share its elements instead of copying them. The elements
+         *          are read by index or through a ConstIterator, without converting the representation.
+         *
+         */
+        class ListStorage
+        {
+        public:
+            /**
+             * @brief Iterator reading the elements of a list by index, whichever representation it uses
+             *
+             */
+            class ConstIterator
+            {
+            public:
+                using iterator_category = std::forward_iterator_tag;
+                using value_type = Value;
+                using difference_type = std::ptrdiff_t;
+                using pointer = const Value*;
+                using reference = const Value&;
+
+                ConstIterator(const ListStorage& storage, std::size_t index) noexcept :
+                    m_storage(&storage), m_index(index)
+                {}
+
+                inline reference operator*() const noexcept { return (*m_storage)[m_index]; }
+                inline pointer operator->() const noexcept { return &(*m_storage)[m_index]; }
+
+                inline ConstIterator& operator++() noexcept
+                {
+                    ++m_index;
+                    return *this;
+                }
+
+                inline ConstIterator operator++(int) noexcept
+                {
+                    ConstIterator it = *this;
+                    ++m_index;
+                    return it;
+                }
+
+                inline bool operator==(const ConstIterator& other) const noexcept { return m_index == other.m_index; }
+                inline bool operator!=(const ConstIterator& other) const noexcept { return m_index != other.m_index; }
+
+                /**
+                 * @brief Position of the element in the list
+                 *
+                 * @return std::size_t
+                 */
+                inline std::size_t index() const noexcept { return m_index; }
+
+            private:
+                const ListStorage* m_storage;
+                std::size_t m_index;
+            };
+
+            ListStorage() = default;
+
+            /**
+             * @brief Construct a new ListStorage object using the std::vector representation
+             *
+             * @param values
+             */
+            explicit ListStorage(std::vector<Value>&& values) noexcept;
+
+            /**
+             * @brief Construct a new ListStorage object using the persistent representation
+             *
+             * @param values
+             */
+            explicit ListStorage(PersistentVector&& values) noexcept;
+
+            /**
+             * @brief Copy a list, in O(1) if it uses the persistent representation
+             *
+             * @param other
+             */
+            ListStorage(const ListStorage& other);
+
+            ListStorage& operator=(const ListStorage&) = delete;
+
+            /**
+             * @brief Check if the persistent representation is used
+             *
+             * @return true
+             * @return false
+             */
+            inline bool persistent() const noexcept;
+
+            /**
+             * @brief Number of elements
+             *
+             * @return std::size_t
+             */
+            inline std::size_t size() const noexcept;
+
+            /**
+             * @brief Read an element
+             *
+             * @param i index of the element, must be smaller than size()
+             * @return const Value&
+             */
+            inline const Value& operator[](std::size_t i) const noexcept;
+
+            inline ConstIterator begin() const noexcept { return ConstIterator(*this, 0); }
+            inline ConstIterator end() const noexcept { return ConstIterator(*this, size()); }
+
+            /**
+             * @brief Copy the elements in a std::vector
+             *
+             * @return std::vector<Value>
+             */
+            std::vector<Value> toVector() const;
+
+            /**
+             * @brief Copy the elements in a PersistentVector
+             *
+             * @return PersistentVector
+             */
+            PersistentVector persistentCopy() const;
+
+            /**
+             * @brief Switch to the std::vector representation to modify the elements
+             *
+             * @return std::vector<Value>&
+             */
+            std::vector<Value>& mutableVector();
+
+            /**
+             * @brief Switch to the persistent representation to modify the elements
+             *
+             * @return PersistentVector&
+             */
+            PersistentVector& mutableTree();
+
+        private:
+            std::vector<Value> m_vector;  ///< Elements of the std::vector representation, empty when the persistent one is used
+            PersistentVector m_tree;
+            bool m_persistent = false;
+        };
+    }
+}
+
+#endif
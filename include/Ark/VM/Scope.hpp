@@ -27,27 +27,62 @@ namespace Ark::internal
     class Scope
     {
     public:
+        /**
+         * @brief A variable stored in the scope
+         * 
+         */
+        struct Binding
+        {
+            uint16_t id;
+            bool is_const;  ///< true for variables created with let
+            Value value;
+        };
+
+        /**
+         * @brief Symbol id of a local variable slot which wasn't assigned yet
+         * 
+         */
+        static constexpr uint16_t UnboundId = 0xffff;
+
         /**
          * @brief Construct a new Scope object
          * 
          */
         Scope() noexcept;
 
+        /**
+         * @brief Construct a new Scope object with unbound local variables slots
+         * 
+         * @param slots number of slots to reserve, accessed by index with the *_LOCAL instructions
+         * @param indexed_by_id if true, each variable is stored in the slot of its symbol id, making
+         *                      lookups O(1) ; used for the global scope, with one slot per symbol
+         */
+        explicit Scope(std::size_t slots, bool indexed_by_id = false) noexcept;
+
         /**
          * @brief Put a value in the scope
          * 
          * @param id The symbol id of the variable
          * @param val The value linked to the symbol
+         * @param is_const true if the variable can not be modified
          */
-        void push_back(uint16_t id, Value&& val) noexcept;
+        void push_back(uint16_t id, Value&& val, bool is_const = false) noexcept;
 
         /**
          * @brief Put a value in the scope
          * 
          * @param id The symbol id of the variable
          * @param val The value linked to the symbol
+         * @param is_const true if the variable can not be modified
+         */
+        void push_back(uint16_t id, const Value& val, bool is_const = false) noexcept;
+
+        /**
+         * @brief Remove all the variables and reserve new unbound slots, keeping the allocated storage
+         * 
+         * @param slots number of slots to reserve, accessed by index with the *_LOCAL instructions
          */
-        void push_back(uint16_t id, const Value& val) noexcept;
+        void reset(std::size_t slots) noexcept;
 
         /**
          * @brief Check if the scope has a specific symbol in memory
@@ -66,6 +101,14 @@ namespace Ark::internal
          */
         Value* operator[](uint16_t id) noexcept;
 
+        /**
+         * @brief Get a variable and its constness from its symbol id
+         * 
+         * @param id 
+         * @return Binding* Returns nullptr if the variable can not be found
+         */
+        Binding* binding(uint16_t id) noexcept;
+
         /**
          * @brief Get the id of a variable based on its value ; used for debug only
          * 
@@ -82,9 +125,11 @@ namespace Ark::internal
         std::size_t size() const noexcept;
 
         friend class Ark::VM;
+        friend class GarbageCollector;
 
     private:
-        std::vector<std::pair<uint16_t, Value>> m_data;
+        std::vector<Binding> m_data;
+        bool m_indexed_by_id;
     };
 }
 
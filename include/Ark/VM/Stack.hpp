@@ -0,0 +1,109 @@
+/**
+ * @file Stack.hpp
+ * @author agent (agent@local)
+ * @brief Memory of the stack of a virtual machine, reserved once and committed on demand
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef ARK_VM_STACK_HPP
+#define ARK_VM_STACK_HPP
+
+#include <cinttypes>
+
+#include <Ark/VM/Value.hpp>
+
+namespace Ark::internal
+{
+    /**
+     * @brief Stack of values of a virtual machine
+     * @details The memory for the maximum number of values is reserved when creating the stack, but
+     *          the values are constructed (thus the memory pages used) only when the stack grows,
+     *          by chunks of 4KB, so that the memory used by a virtual machine follows its deepest call.
+     *          The values stay at the same address for the whole life of the stack. The chunks are given
+     *          back to the system when the virtual machine runs its program again.
+     *
+     */
+    class Stack
+    {
+    public:
+        static constexpr std::size_t ChunkSize = 4096 / sizeof(Value);  ///< Number of values committed at once
+
+        /**
+         * @brief Reserve the memory of a new Stack object, throws std::bad_alloc on failure
+         *
+         * @param capacity maximum number of values
+         */
+        explicit Stack(std::size_t capacity);
+
+        Stack(const Stack&) = delete;
+        Stack& operator=(const Stack&) = delete;
+
+        ~Stack();
+
+        /**
+         * @brief Access a value, which must have been committed
+         *
+         * @param i
+         * @return Value&
+         */
+        inline Value& operator[](std::size_t i) noexcept
+        {
+            return m_data[i];
+        }
+
+        /**
+         * @brief Get a pointer to the first value
+         *
+         * @return Value*
+         */
+        inline Value* data() noexcept
+        {
+            return m_data;
+        }
+
+        /**
+         * @brief Maximum number of values
+         *
+         * @return std::size_t
+         */
+        inline std::size_t capacity() const noexcept
+        {
+            return m_capacity;
+        }
+
+        /**
+         * @brief Number of values which can be used
+         *
+         * @return std::size_t
+         */
+        inline std::size_t committed() const noexcept
+        {
+            return m_committed;
+        }
+
+        /**
+         * @brief Make the given number of values usable, it must not exceed the capacity
+         *
+         * @param size
+         */
+        void commit(std::size_t size);
+
+        /**
+         * @brief Give the memory of the values above the given size back to the system, keeping whole chunks
+         *
+         * @param size number of values to keep usable
+         */
+        void decommit(std::size_t size) noexcept;
+
+    private:
+        Value* m_data;
+        std::size_t m_capacity;
+        std::size_t m_committed;
+    };
+}
+
+#endif
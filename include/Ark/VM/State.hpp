@@ -16,11 +16,33 @@
 #include <vector>
 #include <cinttypes>
 #include <unordered_map>
+#include <array>
+#include <mutex>
+#include <string_view>
+#include <optional>
 
 #include <Ark/VM/Value.hpp>
+#include <Ark/VM/Binding.hpp>
 #include <Ark/Compiler/BytecodeReader.hpp>
 #include <Ark/Compiler/Compiler.hpp>
 
+namespace Ark::internal
+{
+    /**
+     * @brief A bytecode instruction decoded once at load time, with its argument in native endianness
+     * @details Jump addresses are converted to instruction indices in the page, so that the virtual
+     * machine never has to look at the raw bytecode. Instructions without argument have arg = 0.
+     *
+     */
+    struct DecodedInstruction
+    {
+        uint8_t opcode;
+        uint8_t unfused;  ///< Opcode before being turned into a superinstruction, same as opcode otherwise
+        uint16_t arg;
+        uint16_t extra;  ///< Secondary argument: symbol id of the variable for the *_LOCAL instructions, index of the cache of the operators and GET_FIELD in the virtual machines
+    };
+}
+
 namespace Ark
 {
     /**
@@ -38,6 +60,17 @@ namespace Ark
          */
         State(uint16_t options = DefaultFeatures, const std::vector<std::string>& libpath = {}) noexcept;
 
+        State(const State&) = delete;
+        State& operator=(const State&) = delete;
+
+        /**
+         * @brief Destroy the State object, and the interned strings
+         * @details The virtual machines using it must be destroyed before, the values they gave to the host are
+         *          copies which don't depend on it
+         * 
+         */
+        ~State();
+
         /**
          * @brief Feed the state by giving it the path to an existing bytecode file
          * 
@@ -82,6 +115,32 @@ namespace Ark
          */
         void loadFunction(const std::string& name, Value::ProcType function) noexcept;
 
+        /**
+         * @brief Register a function using the old signature in the virtual machine
+         * @details The function will receive a copy of its arguments
+         * 
+         * @param name the name of the function in ArkScript
+         * @param function the code of the function
+         */
+        void loadFunction(const std::string& name, Value::LegacyProcType function) noexcept;
+
+        /**
+         * @brief Register an ordinary C++ function in the virtual machine
+         * @details The wrapper checking the number and types of the arguments, and converting them and
+         *          the result, is generated at compile time (see internal::Binding for the supported types),
+         *          eg `state.bind<&distance>("distance")` with `double distance(double, double)`.
+         *          A function bound under several names uses the last one in its error messages.
+         * 
+         * @tparam Function pointer to the C++ function
+         * @param name the name of the function in ArkScript
+         */
+        template <auto Function>
+        void bind(const std::string& name)
+        {
+            internal::Binding<Function>::name = name;
+            loadFunction(name, &internal::Binding<Function>::call);
+        }
+
         /**
          * @brief Set the script arguments in sys:args
          * 
@@ -103,8 +162,39 @@ namespace Ark
          */
         void setLibDirs(const std::vector<std::string>& libenv) noexcept;
 
+        /**
+         * @brief Get the interned string with the given content, adding it to the intern table of the State if needed
+         * @details The string constants of the bytecode are interned when it is loaded. Interned strings carry
+         *          the hash of their content, and two different interned strings are compared using their hashes.
+         *          The interned strings are frozen: they belong to the State, copying them doesn't touch their
+         *          reference counter, so that virtual machines running in different threads never write to the
+         *          same memory. They live as long as the State, the values given back to the host by a virtual
+         *          machine (VM::call, VM::resolve, VM::callBatch, VM::operator[]) being thawed copies.
+         *          Can be called by multiple threads.
+         * 
+         * @param value 
+         * @return Value a string shared with the other copies of the interned string, modifying it makes a copy. It must not outlive the State
+         */
+        Value intern(const std::string& value);
+
+        /**
+         * @brief Get the id of a symbol, through an index of the symbols table built when loading the bytecode
+         * 
+         * @param name 
+         * @return std::optional<uint16_t> nothing if the bytecode doesn't use this symbol
+         */
+        inline std::optional<uint16_t> symbolId(std::string_view name) const noexcept
+        {
+            if (auto it = m_symbol_ids.find(name); it != m_symbol_ids.end())
+                return it->second;
+            return std::nullopt;
+        }
+
         /**
          * @brief Reset State (all member variables related to execution)
+         * @details The interned strings are kept until the State is destroyed, since the virtual machines may still
+         *          hold copies of them. Loading the same code again interns the same strings, thus the intern table
+         *          only grows with the strings never seen before
          * 
          */
         void reset() noexcept;
@@ -119,6 +209,42 @@ namespace Ark
          */
         void configure();
 
+        /**
+         * @brief Decode a code segment and append it to the code arena
+         *
+         * @param begin index of the first byte of the segment in m_bytecode
+         * @param size size of the segment in bytes
+         */
+        void decodePage(std::size_t begin, uint16_t size);
+
+        /**
+         * @brief Give the index of a new per virtual machine cache to an instruction
+         *
+         * @param count number of caches of this kind, incremented
+         * @return uint16_t index of the cache
+         */
+        static uint16_t nextCache(std::size_t& count) noexcept;
+
+        /**
+         * @brief Replace the first instruction of common sequences by superinstructions
+         * @details The fused instructions are kept in place and skipped by the superinstruction, thus
+         * the jumps don't have to be modified, and can still land in the middle of a sequence.
+         *
+         * @param begin index of the first instruction of the page in m_code
+         */
+        void fuseInstructions(std::size_t begin);
+
+        /**
+         * @brief Get the metadata of a given page (arity, local variables...)
+         *
+         * @param pp page pointer
+         * @return const internal::FunctionInfo&
+         */
+        inline const internal::FunctionInfo& function(std::size_t pp) const noexcept
+        {
+            return m_functions[pp];
+        }
+
         /**
          * @brief Reads and compiles code of file
          * 
@@ -143,8 +269,18 @@ namespace Ark
 
         // related to the bytecode
         std::vector<std::string> m_symbols;
+        std::unordered_map<std::string_view, uint16_t> m_symbol_ids;  ///< Index of the symbols table, the keys point to the content of m_symbols
         std::vector<Value> m_constants;
-        std::vector<bytecode_t> m_pages;
+        std::vector<internal::DecodedInstruction> m_code;  ///< Every page, decoded, stored one after the other
+        std::vector<std::size_t> m_pages_offsets;           ///< Index of the first instruction of each page in m_code
+        std::vector<internal::FunctionInfo> m_functions;    ///< Metadata of each page, from the functions table
+        std::array<std::size_t, internal::Instruction::LAST_FUSED - internal::Instruction::FIRST_FUSED + 1> m_fusions = {};  ///< Number of superinstructions of each kind, for debugging
+        std::size_t m_operator_caches = 0;  ///< Number of caches needed by the operators (ADD...EQ) of the code, at most 65536
+        std::size_t m_field_caches = 0;     ///< Number of caches needed by the GET_FIELD instructions of the code, at most 65536
+        std::size_t m_code_generation = 0;  ///< Incremented each time code is loaded, so that the virtual machines reset their caches
+
+        std::unordered_map<std::string_view, Value> m_interned;  ///< Interned strings, indexed by their content (held by the Value)
+        std::mutex m_interned_mutex;
 
         // related to the execution
         std::unordered_map<std::string, Value> m_binded;
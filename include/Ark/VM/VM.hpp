@@ -21,9 +21,16 @@
 #include <memory>
 #include <unordered_map>
 #include <utility>
-#include <mutex>
+#include <tuple>
+#include <iterator>
+#include <chrono>
+#include <limits>
 
 #include <Ark/VM/Value.hpp>
+#include <Ark/VM/Stack.hpp>
+#include <Ark/VM/GarbageCollector.hpp>
+#include <Ark/VM/ArgsView.hpp>
+#include <Ark/VM/FunctionHandle.hpp>
 #include <Ark/VM/Scope.hpp>
 #include <Ark/VM/State.hpp>
 #include <Ark/Builtins/Builtins.hpp>
@@ -37,7 +44,21 @@ namespace Ark
 {
     using namespace std::string_literals;
 
-    constexpr std::size_t ArkVMStackSize = 8192;
+    constexpr std::size_t ArkVMStackSize = 8192;  ///< Default maximum number of values on the stack of a VM
+    constexpr std::size_t ArkVMScopePoolSize = 1024;  ///< Maximum number of released scopes kept for reuse
+    constexpr std::size_t ArkVMTimeSlice = 10000;      ///< Number of instructions executed between two checks of the deadline given to VM::runUntil
+
+    /**
+     * @brief Status of a program run with a budget (VM::runFor, VM::runUntil)
+     * 
+     */
+    enum class ExecutionStatus
+    {
+        Finished,   ///< The program reached its end, with an exit code of 0
+        Yielded,    ///< The budget was exhausted, the program can be resumed where it stopped
+        Suspended,  ///< A C++ function suspended the program (VM::suspend), which waits for its result (VM::resume)
+        Failed      ///< The program was stopped by an error, or exited with a non zero code
+    };
 
     /**
      * @brief The ArkScript virtual machine, executing ArkScript bytecode
@@ -50,8 +71,28 @@ namespace Ark
          * @brief Construct a new vm t object
          * 
          * @param state a pointer to an ArkScript state, which can be reused for multiple VMs
+         * @param stack_size maximum number of values on the stack, only the part actually used is allocated
          */
-        explicit VM(State* state) noexcept;
+        explicit VM(State* state, std::size_t stack_size = ArkVMStackSize) noexcept;
+
+        /**
+         * @brief Clone a VM which ran its program, to call its functions without running the program again
+         * @details The copy shares the state, the loaded plugins and the user pointer of the original VM, and gets a
+         *          copy of its global variables: strings and lists are copied on write, the closures get a copy of their
+         *          environment. The user types are shared. The stack of the copy starts empty.
+         *          The original VM must not be running, but it can be cloned by multiple threads at the same time.
+         * 
+         * @param other 
+         */
+        VM(const VM& other);
+
+        VM& operator=(const VM&) = delete;
+
+        /**
+         * @brief Destroy the VM object, freeing the values kept alive by reference cycles
+         * 
+         */
+        ~VM();
 
         /**
          * @brief Run the bytecode held in the state
@@ -60,8 +101,64 @@ namespace Ark
          */
         int run() noexcept;
 
+        /**
+         * @brief Run the bytecode held in the state for a limited number of instructions, or resume it
+         * @details The budget is consumed at a few checkpoints only, to keep its cost negligible: a backward jump
+         *          (the end of a loop iteration) costs the number of instructions of the loop, a return costs the
+         *          position of the return in its function, and a call costs 1. Thus the number of instructions
+         *          actually executed is approximate. When the budget is exhausted, the VM stops at the checkpoint
+         *          with its stack, frames and scopes intact, and the next call to runFor (or runUntil) resumes it.
+         *          Only the program itself is suspended, the functions called from C++ (VM::call, VM::resolve)
+         *          always run to completion, and must not be called while the program is suspended.
+         * 
+         * @param instructions approximate number of instructions to execute
+         * @return ExecutionStatus 
+         */
+        ExecutionStatus runFor(std::size_t instructions) noexcept;
+
+        /**
+         * @brief Run the bytecode held in the state until a deadline, or resume it
+         * @details Same as runFor, the clock being read every ArkVMTimeSlice instructions
+         * 
+         * @param deadline 
+         * @return ExecutionStatus 
+         */
+        ExecutionStatus runUntil(std::chrono::steady_clock::time_point deadline) noexcept;
+
+        /**
+         * @brief Suspend the program from a C++ function, instead of blocking while its result isn't ready
+         * @details The function returns the value given by suspend, as a placeholder for its result. The program stops
+         *          right after the call, with its stack, frames and scopes intact, and runFor (or runUntil) returns
+         *          ExecutionStatus::Suspended. The host gives the result later with VM::resume, eg from an event loop
+         *          driving many virtual machines. The program must be run by runFor, runUntil or resume, and the
+         *          function called by the program itself: a function called from C++ (VM::call, VM::resolve) can't
+         *          be suspended, and an error is raised.
+         * 
+         * @return Value the placeholder to return
+         */
+        Value suspend();
+
+        /**
+         * @brief Check if the program was suspended by a C++ function, and waits for VM::resume
+         * 
+         * @return true
+         * @return false
+         */
+        bool suspended() const noexcept;
+
+        /**
+         * @brief Give its result to the C++ function which suspended the program, and resume it like runFor
+         * @details Raises an error if the program isn't suspended
+         * 
+         * @param result the value returned to the program by the function
+         * @param instructions approximate number of instructions to execute
+         * @return ExecutionStatus 
+         */
+        ExecutionStatus resume(Value result, std::size_t instructions = std::numeric_limits<std::size_t>::max());
+
         /**
          * @brief Retrieve a value from the virtual machine, given its symbol name
+         * @details The strings interned by the State it holds are replaced by copies, which can outlive the State
          * 
          * @param name the name of the variable to retrieve
          * @return Value& 
@@ -79,6 +176,41 @@ namespace Ark
         template <typename... Args>
         Value call(const std::string& name, Args&&... args);
 
+        /**
+         * @brief Find an ArkScript function by name, to call it through VM::call without searching for it again
+         * @details Raises an error if the variable doesn't exist or isn't a function
+         * 
+         * @param name the function name in the ArkScript code
+         * @return FunctionHandle 
+         */
+        FunctionHandle function(const std::string& name);
+
+        /**
+         * @brief Call a function from ArkScript through its handle, by giving it arguments
+         * @details The arguments are converted directly on the stack
+         * 
+         * @tparam Args 
+         * @param function a handle given by this VM
+         * @param args C++ argument list, converted to internal representation
+         * @return Value 
+         */
+        template <typename... Args>
+        Value call(const FunctionHandle& function, Args&&... args);
+
+        /**
+         * @brief Call a function from ArkScript once for each set of arguments
+         * @details The calls are made one after the other, with the VM state saved and restored once. An error stops
+         *          only the call which raised it: it is reported in the result of the call, without displaying a
+         *          backtrace, and the next calls are made.
+         * 
+         * @tparam Range a range of tuples (or anything usable with std::apply) of C++ arguments, with a size
+         * @param function a handle given by this VM
+         * @param arguments 
+         * @return std::vector<CallResult> the results, in the order of the arguments
+         */
+        template <typename Range>
+        std::vector<CallResult> callBatch(const FunctionHandle& function, const Range& arguments);
+
         // ================================================
         //         function calling from plugins
         // ================================================
@@ -115,34 +247,110 @@ namespace Ark
          */
         void* getUserPointer() noexcept;
 
+        /**
+         * @brief Free the closures environments which are only referenced by reference cycles
+         * @details Collections are also run automatically, when enough closures were created since the last one
+         * 
+         * @return std::size_t number of environments freed
+         */
+        std::size_t collectGarbage();
+
+        /**
+         * @brief Get the statistics of the garbage collector
+         * 
+         * @return const GCStats& 
+         */
+        const GCStats& gcStats() const noexcept;
+
+        /**
+         * @brief Set the minimum number of closures to create before running a collection
+         * 
+         * @param threshold defaults to ArkGCThreshold
+         */
+        void setGCThreshold(std::size_t threshold) noexcept;
+
+        /**
+         * @brief Set the maximum number of closures environments alive, the VM stops with an error
+         *        if a collection can't bring their number under this limit
+         * 
+         * @param limit 0 for no limit (default)
+         */
+        void setHeapLimit(std::size_t limit) noexcept;
+
         friend class Value;
         friend class Repl;
 
     private:
-        State* m_state;
+        const State* m_state;  ///< read only, thus the state can be shared by virtual machines running in different threads
 
         int m_exit_code;   ///< VM exit code, defaults to 0. Can be changed through `sys:exit`
-        int m_ip;          ///< instruction pointer
+        int m_ip;          ///< instruction pointer, index of the current decoded instruction in the current page
         std::size_t m_pp;  ///< page pointer
-        uint16_t m_sp;     ///< stack pointer
-        uint16_t m_fc;     ///< current frames count
+        std::size_t m_sp;  ///< stack pointer
+        std::size_t m_fc;  ///< current frames count
         bool m_running;
         uint16_t m_last_sym_loaded;
         std::size_t m_until_frame_count;
-        std::mutex m_mutex;
+        bool m_yielded;         ///< true when the program was suspended by runFor, runUntil or a C++ function, to be resumed
+        bool m_suspended;       ///< true when a C++ function suspended the program, until it gets its result
+        bool m_can_suspend;     ///< true while the program is run by runFor, runUntil or resume
+        std::int64_t m_budget;  ///< Budget of instructions given to the next run of the program
+        std::optional<std::chrono::steady_clock::time_point> m_deadline;  ///< Deadline given to runUntil
 
         // related to the execution
-        std::unique_ptr<std::array<Value, ArkVMStackSize>> m_stack;
+        std::size_t m_stack_size;
+        std::unique_ptr<internal::Stack> m_stack;
         std::vector<uint8_t> m_scope_count_to_delete;
         std::optional<internal::Scope_t> m_saved_scope;
         std::vector<internal::Scope_t> m_locals;
+        std::vector<internal::Scope_t> m_scope_pool;  ///< Released scopes, reused by createNewScope to avoid allocations
         std::vector<std::shared_ptr<internal::SharedLibrary>> m_shared_lib_objects;
+        internal::GarbageCollector m_gc;
 
         // just a nice little trick for operator[] and for pop
         Value m_no_value = internal::Builtins::nil;
 
         void* m_user_pointer;  ///< needed to pass data around when binding ArkScript in a program
 
+        /**
+         * @brief Inline cache of a GET_FIELD instruction
+         * 
+         */
+        struct FieldCache
+        {
+            internal::PageAddr_t page = 0;                  ///< Page address of the last closure read, identifying its captures layout
+            uint16_t slot = internal::Scope::UnboundId;  ///< Index of the field in the scope of the closure
+        };
+
+        std::vector<FieldCache> m_field_caches;  ///< One cache per GET_FIELD instruction, indexed by its extra field
+        std::vector<uint8_t> m_operators;        ///< State of each operator instruction (ADD...EQ), indexed by its extra field: QuickenedOperator flag and number of deoptimizations
+        std::size_t m_code_generation;           ///< Generation of the code of the state the caches were made for
+
+        /// Set in the state of an operator once it was applied to numbers, to use its version specialized for numbers
+        static constexpr uint8_t QuickenedOperator = 0x80;
+        /// Number of times an operator can fall back to its generic version before it stops being quickened
+        static constexpr uint8_t MaxDeoptimizations = 4;
+
+        /// Budget of the runs which can't be suspended
+        static constexpr std::int64_t UnlimitedBudget = std::numeric_limits<std::int64_t>::max();
+
+        /**
+         * @brief Start the program, or resume it if it yielded, with a budget of instructions
+         * 
+         * @param budget 
+         * @return ExecutionStatus 
+         */
+        ExecutionStatus runWithBudget(std::int64_t budget) noexcept;
+
+        /**
+         * @brief Called when the budget of a run is exhausted, to refill it if the deadline isn't reached yet
+         * 
+         * @param budget the budget of the run, modified if it is refilled
+         * @return true if the program must yield
+         * @return false if it can go on
+         */
+        bool budgetExhausted(std::int64_t& budget) const noexcept;
+
         /**
          * @brief Run ArkScript bytecode inside a try catch to retrieve all the exceptions and display a stack trace if needed
          * 
@@ -152,18 +360,36 @@ namespace Ark
         int safeRun(std::size_t untilFrameCount = 0);
 
         /**
-         * @brief Initialize the VM according to the parameters
+         * @brief Convert arguments for a function call right on the stack, in the order CALL expects them (the first one being the deepest)
+         * 
+         * @tparam Args 
+         * @param args C++ argument list
+         */
+        template <typename... Args>
+        inline void pushArguments(Args&&... args);
+
+        /**
+         * @brief Remove the frames, scopes and values left by a call which raised an error, to make other calls
          * 
+         * @param frames_count frame count before the call
+         * @param sp stack pointer before the call
+         * @param locals_count number of scopes before the call
          */
-        void init() noexcept;
+        void unwind(std::size_t frames_count, std::size_t sp, std::size_t locals_count) noexcept;
 
         /**
-         * @brief Read a 2 bytes number from the current bytecode page, starting at the current instruction
-         * @details Modify the instruction pointer to point on the instruction right after the number.
+         * @brief Run ArkScript bytecode, until the frame count reaches the given one or HALT is executed
+         * @details The exceptions are propagated, with m_ip set to the instruction which failed
+         * 
+         * @param untilFrameCount the frame count we need to reach before stopping the VM
+         */
+        void execute(std::size_t untilFrameCount);
+
+        /**
+         * @brief Initialize the VM according to the parameters
          * 
-         * @return uint16_t 
          */
-        inline uint16_t readNumber();
+        void init() noexcept;
 
         // ================================================
         //                 stack related
@@ -194,8 +420,9 @@ namespace Ark
          * @brief Push a value on the stack as a reference
          * 
          * @param valptr 
+         * @param is_const true if the value must not be modified through the reference
          */
-        inline void push(Value* valptr);
+        inline void push(Value* valptr, bool is_const = false);
 
         /**
          * @brief Pop a value from the stack and resolve it if possible, then return it
@@ -204,6 +431,15 @@ namespace Ark
          */
         inline Value* popAndResolveAsPtr();
 
+        /**
+         * @brief Pop a value from the stack and resolve it if possible, then return it
+         * @details Temporary values are moved out of the stack, so that it doesn't keep a reference
+         *          on their data (which would force a copy the next time they are modified)
+         * 
+         * @return Value 
+         */
+        inline Value popValue();
+
         /**
          * @brief Move stack values around and invert them
          * @details values:     1,  2, 3, _, _
@@ -214,11 +450,54 @@ namespace Ark
          */
         inline void swapStackForFunCall(uint16_t argc);
 
+        /**
+         * @brief Try to call a function in tail position by reusing the current frame
+         * 
+         * @details Only a function calling itself can reuse its frame: the others may need the variables
+         * of their caller, since a function can see the scopes of the functions which called it.
+         * 
+         * @param argc number of arguments given to the function
+         * @return true if the frame was reused, the execution continues at the start of the current page
+         * @return false if the call must be done normally
+         */
+        inline bool tailCall(uint16_t argc);
+
+        /**
+         * @brief Check that the stack can hold the values used by a function before calling it
+         * 
+         * @param pp page pointer of the function
+         */
+        inline void checkStackRoom(internal::PageAddr_t pp);
+
+        /**
+         * @brief Make room on the stack for more values, throws a "stack overflow" error if the stack is full
+         * 
+         * @param size number of values needed on the stack
+         */
+        inline void growStack(std::size_t size);
+
+        /**
+         * @brief Run a collection, throws an error if too many closures environments are still alive
+         * 
+         */
+        inline void collectCycles();
+
         // ================================================
         //                locals related
         // ================================================
 
-        inline void createNewScope() noexcept;
+        /**
+         * @brief Create a new scope on top of the locals
+         *
+         * @param slots number of local variables slots to reserve in the scope
+         */
+        inline void createNewScope(std::size_t slots = 0) noexcept;
+
+        /**
+         * @brief Remove the scope on top of the locals, and recycle it if it wasn't captured
+         * 
+         */
+        inline void popScope() noexcept;
 
         /**
          * @brief Find the nearest variable of a given id
@@ -228,6 +507,79 @@ namespace Ark
          */
         inline Value* findNearestVariable(uint16_t id) noexcept;
 
+        /**
+         * @brief Find the nearest variable of a given id, alongside its constness
+         * 
+         * @param id the id to find
+         * @return internal::Scope::Binding* 
+         */
+        inline internal::Scope::Binding* findNearestBinding(uint16_t id) noexcept;
+
+        /**
+         * @brief Copy a value for a clone of a VM, giving a copy of their environment to the closures it holds
+         * 
+         * @param value 
+         * @param copies the copies of the environments already made, indexed by their original
+         * @return Value 
+         */
+        Value cloneValue(const Value& value, std::unordered_map<const internal::Scope*, internal::Scope_t>& copies);
+
+        /**
+         * @brief Copy an environment for a clone of a VM, only once per environment
+         * 
+         * @param scope 
+         * @param copies the copies of the environments already made, indexed by their original
+         * @return internal::Scope_t 
+         */
+        internal::Scope_t cloneScope(const internal::Scope_t& scope, std::unordered_map<const internal::Scope*, internal::Scope_t>& copies);
+
+        /**
+         * @brief Get a constant of the State, to be pushed as a constant reference
+         * @details The State is shared by the virtual machines, the constants must never be modified through the pointer
+         *
+         * @param id
+         * @return Value*
+         */
+        inline Value* constant(uint16_t id) const noexcept;
+
+        /**
+         * @brief Get the value a LOAD_SYMBOL, LOAD_LOCAL or LOAD_CONST instruction would put on the stack
+         * @details Used by the superinstructions, to avoid pushing and popping their operands
+         * 
+         * @param inst the load instruction
+         * @return Value* 
+         */
+        inline Value* loadOperand(const internal::DecodedInstruction& inst);
+
+        /**
+         * @brief Find the variable a STORE or STORE_LOCAL instruction modifies
+         * @details Raise an error if the variable is unbound or constant
+         * 
+         * @param inst the store instruction
+         * @return internal::Scope::Binding* 
+         */
+        inline internal::Scope::Binding* findStoreTarget(const internal::DecodedInstruction& inst);
+
+        /**
+         * @brief Find a field in the scope of a closure, for the GET_FIELD instruction
+         * @details Closures created from the same page capture the same variables in the same order,
+         *          thus the slot found for a given page is remembered and tried first next time
+         * 
+         * @param closure the closure to read from
+         * @param id the symbol id of the field
+         * @param cache_id index of the cache of the GET_FIELD instruction
+         * @return internal::Scope::Binding* nullptr if the field doesn't exist
+         */
+        inline internal::Scope::Binding* findField(internal::Closure& closure, uint16_t id, uint16_t cache_id) noexcept;
+
+        /**
+         * @brief Get the first instruction of a given page, in the code of the state
+         * 
+         * @param pp page pointer
+         * @return internal::DecodedInstruction* 
+         */
+        inline const internal::DecodedInstruction* codePage(std::size_t pp) const noexcept;
+
         /**
          * @brief Destroy the current frame and get back to the previous one, resuming execution
          * 
@@ -237,6 +589,79 @@ namespace Ark
          */
         inline void returnFromFuncCall();
 
+        /**
+         * @brief Call a builtin or a function from a plugin, with arguments taken from the stack
+         * 
+         * @param function the CProc to call
+         * @param argc number of arguments
+         */
+        inline void callProc(const Value& function, uint16_t argc);
+
+        // ================================================
+        //                   operators
+        // ================================================
+
+        /**
+         * @brief Apply a binary operator (ADD, SUB, MUL, DIV, MOD or a comparison)
+         * 
+         * @tparam Op the operator instruction
+         * @param a first operand, already resolved
+         * @param b second operand, already resolved
+         * @return Value 
+         */
+        template <uint8_t Op>
+        inline static Value binaryOperator(Value* a, Value* b);
+
+        /**
+         * @brief Apply a binary operator known at runtime only
+         * 
+         * @param op the operator instruction
+         * @param a first operand, already resolved
+         * @param b second operand, already resolved
+         * @return Value 
+         */
+        inline static Value binaryOperator(uint8_t op, Value* a, Value* b);
+
+        /**
+         * @brief Compare two values (GT, LT, LE, GE, NEQ or EQ)
+         * 
+         * @tparam Op the comparison instruction
+         * @param a first operand, already resolved
+         * @param b second operand, already resolved
+         * @return bool 
+         */
+        template <uint8_t Op>
+        inline static bool compare(const Value* a, const Value* b);
+
+        /**
+         * @brief Compare two values with a comparison known at runtime only
+         * 
+         * @param op the comparison instruction
+         * @param a first operand, already resolved
+         * @param b second operand, already resolved
+         * @return bool 
+         */
+        inline static bool compare(uint8_t op, const Value* a, const Value* b);
+
+        /**
+         * @brief Switch a generic operator (ADD...EQ) to its version specialized for numbers, if it was applied to numbers
+         * 
+         * @param op the state of the operator instruction, in m_operators
+         * @param a first operand, already resolved
+         * @param b second operand, already resolved
+         */
+        inline static void quicken(uint8_t& op, const Value* a, const Value* b) noexcept;
+
+        /**
+         * @brief Execute a quickened operator, specialized for numbers, replacing its operands on the stack by the result
+         * @details If the operands aren't numbers, the instruction goes back to the generic operator
+         * 
+         * @tparam Op the operator instruction
+         * @param op the state of the operator instruction, in m_operators
+         */
+        template <uint8_t Op>
+        inline void numberOperator(uint8_t& op);
+
         /**
          * @brief Load a plugin from a constant id
          * 
@@ -13,27 +13,38 @@
 #define ARK_VM_VALUE_HPP
 
 #include <vector>
-#include <variant>
 #include <string>  // for conversions
 #include <cinttypes>
+#include <cstring>
 #include <iostream>
 #include <memory>
 #include <functional>
 #include <utility>
+#include <algorithm>
 #include <Ark/String.hpp>  // our string implementation
 #include <array>
+#include <atomic>
+#include <type_traits>
 
 #include <Ark/VM/Closure.hpp>
 #include <Ark/VM/UserType.hpp>
+#include <Ark/VM/PersistentVector.hpp>
 #include <Ark/Platform.hpp>
 #include <Ark/Profiling.hpp>
 
 namespace Ark
 {
     class VM;
+    class State;
+    class ArgsView;
 
-    // Note from the creator: we can have at most 0b01111111 (127) different types
-    // because type index is stored on the 7 right most bits of a uint8_t in the class Value.
+    namespace internal
+    {
+        class GarbageCollector;
+    }
+
+    // Note from the creator: we can have at most 15 different types because the type index
+    // is stored on 4 bits in the NaN-boxed representation of the class Value (0xFFF1 + type).
     // Order is also important because we are doing some optimizations to check ranges
     // of types based on their integer values.
     enum class ValueType
@@ -66,24 +77,56 @@ namespace Ark
     extern unsigned value_creations, value_copies, value_moves;
 #endif
 
+    namespace internal
+    {
+        constexpr uint32_t FrozenRefcount = 1u << 31;  ///< Reference counter of the cells owned by a State, which copies don't modify
+
+        /**
+         * @brief Reference counted heap cell, holding the objects which can not fit in a Value
+         * 
+         * @tparam T the type of the object
+         */
+        template <typename T>
+        struct ValueBox
+        {
+            T data;
+            std::atomic<uint32_t> refcount = 1;  ///< Atomic because the values can be shared by virtual machines running in different threads
+        };
+
+        /**
+         * @brief Heap cell of the strings, which can be interned by a State
+         * 
+         */
+        template <>
+        struct ValueBox<String>
+        {
+            String data;
+            std::atomic<uint32_t> refcount = 1;
+            std::size_t hash = 0;  ///< Hash of the content of an interned string (always odd), 0 if the string isn't interned
+        };
+    }
+
+    /**
+     * @brief The value type handled by the virtual machine
+     * @details A Value is NaN-boxed on 8 bytes: numbers are stored as-is (every NaN is turned into
+     *          the positive quiet NaN), every other type is stored in the negative NaN space, with
+     *          the type in bits 48 to 51 and a 48 bits payload (page address, C++ function pointer,
+     *          reference, or pointer to a heap allocated ValueBox for strings, lists, closures and
+     *          user types). The ValueBox are shared between the copies of a Value: closures and user types
+     *          have a reference semantic, while strings and lists are copied when a shared one is modified.
+     *          Big lists are then copied in a persistent vector, sharing their elements with the original list.
+     *          Strings interned by a State carry the hash of their content, to compare them without reading them.
+     * 
+     */
     class ARK_API Value
     {
     public:
-        using ProcType = Value (*)(std::vector<Value>&, Ark::VM*);  // std::function<Value (std::vector<Value>&, Ark::VM*)>
+        using ProcType = Value (*)(ArgsView, Ark::VM*);
+        using LegacyProcType = Value (*)(std::vector<Value>&, Ark::VM*);  ///< Old signature of the C++ functions, receiving a copy of their arguments
         using Iterator = std::vector<Value>::iterator;
         using ConstIterator = std::vector<Value>::const_iterator;
 
-        using Value_t = std::variant<
-            double,                //  8 bytes
-            String,                // 16 bytes
-            internal::PageAddr_t,  //  2 bytes
-            ProcType,              //  8 bytes
-            internal::Closure,     // 24 bytes
-            UserType,              // 24 bytes
-            std::vector<Value>,    // 24 bytes
-            Value*                 //  8 bytes
-            >;                     // +8 bytes overhead
-        //                      total 32 bytes
+        using Value_t = uint64_t;  ///< NaN-boxed representation, 8 bytes
 
         /**
          * @brief Construct a new Value object
@@ -101,23 +144,46 @@ namespace Ark
         /**
          * @brief Construct a new Value object
          * @details Use at your own risks. Asking for a value type N and putting a non-matching value
-         *          will result in errors at runtime.
+         *          will result in errors at runtime. Numbers given for ValueType::Number are converted
+         *          to double, other integers are stored as is (page addresses, instruction pointers).
+         *          Strings, lists, closures and user types go through their own constructor, which
+         *          allocates the ValueBox the accessors expect (a list is held in a ListStorage).
          *
          * @tparam T 
          * @param type value type wanted
          * @param value value needed
          */
         template <typename T>
-        Value(ValueType type, T&& value) noexcept :
-            m_const_type(static_cast<uint8_t>(type)),
-            m_value(value)
-        {}
-
-#ifdef ARK_PROFILER_COUNT
-        Value(const Value& val) noexcept;
+        Value(ValueType type, T&& value) noexcept
+        {
+            using U = std::decay_t<T>;
+
+            if constexpr (std::is_floating_point_v<U>)
+                *this = Value(static_cast<double>(value));
+            else if constexpr (std::is_integral_v<U>)
+            {
+                if (type == ValueType::Number)
+                    *this = Value(static_cast<double>(value));
+                else
+                    m_bits = box(type, static_cast<uint64_t>(value));
+            }
+            else if constexpr (std::is_same_v<U, const char*> || std::is_same_v<U, char*>)
+                *this = Value(static_cast<const char*>(value));
+            else if constexpr (std::is_pointer_v<U>)
+                m_bits = box(type, reinterpret_cast<uint64_t>(value));
+            else
+            {
+                static_assert(std::is_constructible_v<Value, U&&>, "Value(ValueType, T): no Value constructor accepts this payload");
+                // copy lvalues so that the rvalue-only constructors (lists, closures, user types) are reachable
+                *this = Value(U(std::forward<T>(value)));
+            }
+        }
+
+        Value(const Value& other) noexcept;
         Value(Value&& other) noexcept;
         Value& operator=(const Value& other) noexcept;
-#endif
+        Value& operator=(Value&& other) noexcept;
+        ~Value();
 
         /**
          * @brief Construct a new Value object as a Number
@@ -175,6 +241,15 @@ namespace Ark
          */
         explicit Value(Value::ProcType value) noexcept;
 
+        /**
+         * @brief Construct a new Value object from a C++ function using the old signature
+         * @details The pointer is kept in the value with a flag, so that the virtual machine gives the
+         *          function a copy of its arguments in a vector.
+         * 
+         * @param value 
+         */
+        explicit Value(Value::LegacyProcType value) noexcept;
+
         /**
          * @brief Construct a new Value object as a List
          * 
@@ -233,11 +308,12 @@ namespace Ark
         inline const String& string() const;
 
         /**
-         * @brief Return the stored list
+         * @brief Return the elements of the stored list
+         * @details They are held in a std::vector or in a persistent vector, and read by index or with an iterator
          * 
-         * @return const std::vector<Value>& 
+         * @return const internal::ListStorage& 
          */
-        inline const std::vector<Value>& constList() const;
+        inline const internal::ListStorage& constList() const;
 
         /**
          * @brief Return the stored user type
@@ -248,6 +324,7 @@ namespace Ark
 
         /**
          * @brief Return the stored list as a reference
+         * @details The list is copied first if it is shared with other values
          * 
          * @return std::vector<Value>& 
          */
@@ -255,6 +332,7 @@ namespace Ark
 
         /**
          * @brief Return the stored string as a reference
+         * @details The string is copied first if it is shared with other values
          * 
          * @return String& 
          */
@@ -272,7 +350,7 @@ namespace Ark
          * 
          * @return Value* 
          */
-        Value* reference() const;
+        inline Value* reference() const;
 
         /**
          * @brief Add an element to the list held by the value (if the value type is set to list)
@@ -288,16 +366,114 @@ namespace Ark
          */
         void push_back(Value&& value);
 
+        /**
+         * @brief Replace an element of the list held by the value
+         * 
+         * @param i index of the element, must be smaller than the size of the list
+         * @param value 
+         */
+        void setAt(std::size_t i, Value&& value);
+
+        /**
+         * @brief Remove an element of the list held by the value
+         * @details Removing the first or the last element of a big list doesn't copy it
+         * 
+         * @param i index of the element, must be smaller than the size of the list
+         */
+        void erase(std::size_t i);
+
         friend ARK_API std::ostream& operator<<(std::ostream& os, const Value& V) noexcept;
         friend ARK_API_INLINE bool operator==(const Value& A, const Value& B) noexcept;
         friend ARK_API_INLINE bool operator<(const Value& A, const Value& B) noexcept;
         friend ARK_API_INLINE bool operator!(const Value& A) noexcept;
 
         friend class Ark::VM;
+        friend class Ark::State;
+        friend class Ark::internal::GarbageCollector;
 
     private:
-        uint8_t m_const_type;  ///< First bit if for constness, right most bits are for type
-        Value_t m_value;
+        static constexpr uint64_t BoxedBase = 0xFFF1000000000000ULL;    ///< Smallest boxed value, everything under is a number
+        static constexpr uint64_t PayloadMask = 0x0000FFFFFFFFFFFFULL;  ///< 48 right most bits
+        static constexpr uint64_t CanonicalNaN = 0x7FF8000000000000ULL;
+        static constexpr uint64_t LegacyProcFlag = 1ULL << 47;           ///< Set in the payload of a CProc using the old signature, above the user space addresses
+        /// Types stored in a ValueBox, one bit per ValueType
+        static constexpr uint32_t HeapTypes = (1 << static_cast<int>(ValueType::List)) |
+            (1 << static_cast<int>(ValueType::String)) |
+            (1 << static_cast<int>(ValueType::Closure)) |
+            (1 << static_cast<int>(ValueType::User));
+
+        Value_t m_bits;
+
+        /**
+         * @brief Create the NaN-boxed representation of a non-number value
+         * 
+         * @param type 
+         * @param payload must fit on 48 bits
+         * @return Value_t 
+         */
+        static constexpr Value_t box(ValueType type, uint64_t payload) noexcept
+        {
+            return (BoxedBase + (static_cast<uint64_t>(type) << 48)) | (payload & PayloadMask);
+        }
+
+        /**
+         * @brief Return the payload as a pointer
+         * 
+         * @return T* 
+         */
+        template <typename T>
+        inline T* payloadAs() const noexcept
+        {
+            return reinterpret_cast<T*>(m_bits & PayloadMask);
+        }
+
+        /**
+         * @brief Return the object held in the heap cell
+         * 
+         * @return T& 
+         */
+        template <typename T>
+        inline T& boxed() const noexcept
+        {
+            return payloadAs<internal::ValueBox<T>>()->data;
+        }
+
+        /**
+         * @brief Check if the value owns a heap cell
+         * 
+         * @return true 
+         * @return false 
+         */
+        inline bool isHeapObject() const noexcept;
+
+        /**
+         * @brief Get the boxed object to modify it, giving this value its own copy if the object is shared
+         * 
+         * @tparam T type of the boxed object (String or std::vector<Value>)
+         * @return T& 
+         */
+        template <typename T>
+        T& unshare();
+
+        /**
+         * @brief Get the list to modify it, giving this value its own copy if the list is shared
+         * @details A big shared list is copied in the persistent representation
+         * 
+         * @return internal::ListStorage& 
+         */
+        internal::ListStorage& unshareList();
+
+        /**
+         * @brief Take a new reference on the heap cell, or duplicate it for strings and lists
+         * 
+         */
+        void acquire() noexcept;
+
+        /**
+         * @brief Drop the reference on the heap cell, and delete it if it was the last one
+         * 
+         */
+        void release() noexcept;
 
         // private getters only for the virtual machine
 
@@ -311,9 +487,33 @@ namespace Ark
         /**
          * @brief Return the C Function held by the value
          * 
-         * @return const ProcType& 
+         * @return ProcType 
+         */
+        inline ProcType proc() const;
+
+        /**
+         * @brief Check if the C Function held by the value uses the old signature
+         * 
+         * @return true 
+         * @return false 
+         */
+        inline bool isLegacyProc() const noexcept;
+
+        /**
+         * @brief Return the C Function using the old signature held by the value
+         * 
+         * @return LegacyProcType 
+         */
+        inline LegacyProcType legacyProc() const;
+
+        /**
+         * @brief Copy of the value which doesn't use the cells owned by a State, to give it to the host
+         * @details The frozen strings are copied, as well as the lists holding some (recursively). Closures and
+         *          user types are given as is, they can only be used by a virtual machine, thus with its State.
+         * 
+         * @return Value 
          */
-        inline const ProcType& proc() const;
+        Value thawed() const;
 
         /**
          * @brief Return the closure held by the value
@@ -330,7 +530,10 @@ namespace Ark
         internal::Closure& refClosure();
 
         /**
-         * @brief Check if the value is const or not
+         * @brief Check if the value is a reference to a constant
+         * @details Constness is a property of the variables, held by the scopes. The virtual machine
+         *          keeps it in the references it pushes on the stack, to check it in the instructions
+         *          modifying their argument in place.
          * 
          * @return true 
          * @return false 
@@ -338,7 +541,7 @@ namespace Ark
         inline bool isConst() const noexcept;
 
         /**
-         * @brief Set the Const object
+         * @brief Set the constness of a reference, does nothing on other value types
          * 
          * @param value 
          */
@@ -346,6 +549,7 @@ namespace Ark
     };
 
 #include "inline/Value.inl"
+#include "inline/PersistentVector.inl"
 }
 
 #endif
@@ -0,0 +1,14 @@
+inline bool internal::ListStorage::persistent() const noexcept
+{
+    return m_persistent;
+}
+
+inline std::size_t internal::ListStorage::size() const noexcept
+{
+    return m_persistent ? m_tree.size() : m_vector.size();
+}
+
+inline const Value& internal::ListStorage::operator[](std::size_t i) const noexcept
+{
+    return m_persistent ? m_tree[i] : m_vector[i];
+}
@@ -3,56 +3,33 @@
 // ------------------------------------------
 
 #define resolveRef(valptr) (((valptr)->valueType() == ValueType::Reference) ? *((valptr)->reference()) : *(valptr))
-#define resolveRefInPlace(val)                            \
-    if (val.valueType() == ValueType::Reference)          \
-    {                                                     \
-        val.m_const_type = val.reference()->m_const_type; \
-        val.m_value = val.reference()->m_value;           \
-    }
+#define resolveRefInPlace(val)                   \
+    if (val.valueType() == ValueType::Reference) \
+        val = *val.reference();
 
 // profiler
 #include <Ark/Profiling.hpp>
 
 template <typename... Args>
 Value VM::call(const std::string& name, Args&&... args)
+{
+    return call(function(name), std::forward<Args>(args)...);
+}
+
+template <typename... Args>
+Value VM::call(const FunctionHandle& function, Args&&... args)
 {
     using namespace internal;
 
-    const std::lock_guard<std::mutex> lock(m_mutex);
+    if (function.m_vm != this)
+        throwVMError("the function handle was given by another virtual machine");
 
-    // reset ip and pp
-    m_ip = 0;
-    m_pp = 0;
-
-    // find id of function
-    auto it = std::find(m_state->m_symbols.begin(), m_state->m_symbols.end(), name);
-    if (it == m_state->m_symbols.end())
-        throwVMError("unbound variable: " + name);
-
-    // convert and push arguments in reverse order
-    std::vector<Value> fnargs { { Value(args)... } };
-    for (auto it2 = fnargs.rbegin(), it_end = fnargs.rend(); it2 != it_end; ++it2)
-        push(*it2);
-
-    // find function object and push it if it's a pageaddr/closure
-    uint16_t id = static_cast<uint16_t>(std::distance(m_state->m_symbols.begin(), it));
-    Value* var = findNearestVariable(id);
-    if (var != nullptr)
-    {
-        ValueType vt = var->valueType();
-
-        if (vt != ValueType::PageAddr &&
-            vt != ValueType::Closure &&
-            !(vt == ValueType::Reference &&
-              (var->reference()->valueType() == ValueType::PageAddr ||
-               var->reference()->valueType() == ValueType::Closure)))
-            throwVMError("Can't call '" + name + "': it isn't a Function but a " + types_to_str[static_cast<int>(vt)]);
+    int ip = m_ip;
+    std::size_t pp = m_pp;
 
-        push(Value(var));
-        m_last_sym_loaded = id;
-    }
-    else
-        throwVMError("Couldn't find variable " + name);
+    pushArguments(std::forward<Args>(args)...);
+    push(function.m_function);
+    m_last_sym_loaded = function.m_id;
 
     std::size_t frames_count = m_fc;
     // call it
@@ -65,8 +42,62 @@ Value VM::call(const std::string& name, Args&&... args)
     // run until the function returns
     safeRun(/* untilFrameCount */ frames_count);
 
-    // get result
-    return *popAndResolveAsPtr();
+    // restore VM state
+    m_ip = ip;
+    m_pp = pp;
+
+    // get result, without the cells of the State so that it can outlive it
+    return popAndResolveAsPtr()->thawed();
+}
+
+template <typename Range>
+std::vector<CallResult> VM::callBatch(const FunctionHandle& function, const Range& arguments)
+{
+    using namespace internal;
+
+    if (function.m_vm != this)
+        throwVMError("the function handle was given by another virtual machine");
+
+    int ip = m_ip;
+    std::size_t pp = m_pp;
+    std::size_t frames_count = m_fc;
+    std::size_t sp = m_sp;
+    std::size_t locals_count = m_locals.size();
+
+    std::vector<CallResult> results;
+    results.reserve(std::size(arguments));
+
+    for (const auto& item : arguments)
+    {
+        try
+        {
+            std::apply([this](const auto&... args) { pushArguments(args...); }, item);
+            push(function.m_function);
+            m_last_sym_loaded = function.m_id;
+
+            call(static_cast<int16_t>(std::tuple_size_v<std::decay_t<decltype(item)>>));
+            m_ip = 0;
+            execute(frames_count);
+
+            results.push_back(CallResult { popAndResolveAsPtr()->thawed(), std::nullopt });
+        }
+        catch (const std::exception& e)
+        {
+            unwind(frames_count, sp, locals_count);
+            results.push_back(CallResult { Builtins::nil, std::string(e.what()) });
+        }
+        catch (...)
+        {
+            unwind(frames_count, sp, locals_count);
+            results.push_back(CallResult { Builtins::nil, std::string("Unknown error") });
+        }
+    }
+
+    // restore VM state
+    m_ip = ip;
+    m_pp = pp;
+
+    return results;
 }
 
 template <typename... Args>
@@ -74,18 +105,13 @@ Value VM::resolve(const Value* val, Args&&... args)
 {
     using namespace internal;
 
-    const std::lock_guard<std::mutex> lock(m_mutex);
-
     if (!val->isFunction())
         throw TypeError("Value::resolve couldn't resolve a non-function");
 
     int ip = m_ip;
     std::size_t pp = m_pp;
 
-    // convert and push arguments in reverse order
-    std::vector<Value> fnargs { { Value(args)... } };
-    for (auto it = fnargs.rbegin(), it_end = fnargs.rend(); it != it_end; ++it)
-        push(resolveRef(it));
+    pushArguments(std::forward<Args>(args)...);
     // push function
     push(resolveRef(val));
 
@@ -104,20 +130,22 @@ Value VM::resolve(const Value* val, Args&&... args)
     m_ip = ip;
     m_pp = pp;
 
-    // get result
-    return *popAndResolveAsPtr();
+    // get result, without the cells of the State so that it can outlive it
+    return popAndResolveAsPtr()->thawed();
 }
 
 #pragma region "stack management"
 
-inline uint16_t VM::readNumber()
+template <typename... Args>
+inline void VM::pushArguments(Args&&... args)
 {
-    uint16_t tmp =
-        (static_cast<uint16_t>(m_state->m_pages[m_pp][m_ip]) << 8) +
-        static_cast<uint16_t>(m_state->m_pages[m_pp][m_ip + 1]);
+    std::size_t top = m_sp + sizeof...(Args);
+    if (top > m_stack->committed())
+        growStack(top);
 
-    ++m_ip;
-    return tmp;
+    std::size_t i = m_sp;
+    ((void)((*m_stack)[i++] = Value(std::forward<Args>(args))), ...);
+    m_sp = top;
 }
 
 inline Value* VM::pop()
@@ -133,22 +161,26 @@ inline Value* VM::pop()
 
 inline void VM::push(const Value& value)
 {
-    (*m_stack)[m_sp].m_const_type = value.m_const_type;
-    (*m_stack)[m_sp].m_value = value.m_value;
+    if (m_sp >= m_stack->committed())
+        growStack(m_sp + 1);
+    (*m_stack)[m_sp] = value;
     ++m_sp;
 }
 
 inline void VM::push(Value&& value)
 {
-    (*m_stack)[m_sp].m_const_type = std::move(value.m_const_type);
-    (*m_stack)[m_sp].m_value = std::move(value.m_value);
+    if (m_sp >= m_stack->committed())
+        growStack(m_sp + 1);
+    (*m_stack)[m_sp] = std::move(value);
     ++m_sp;
 }
 
-inline void VM::push(Value* valptr)
+inline void VM::push(Value* valptr, bool is_const)
 {
-    (*m_stack)[m_sp].m_const_type = static_cast<uint8_t>(ValueType::Reference);
-    (*m_stack)[m_sp].m_value = valptr;
+    if (m_sp >= m_stack->committed())
+        growStack(m_sp + 1);
+    (*m_stack)[m_sp] = Value(valptr);
+    (*m_stack)[m_sp].setConst(is_const);
     ++m_sp;
 }
 
@@ -160,6 +192,16 @@ inline Value* VM::popAndResolveAsPtr()
     return tmp;
 }
 
+inline Value VM::popValue()
+{
+    Value* tmp = pop();
+    if (tmp->valueType() == ValueType::Reference)
+        return *tmp->reference();
+    if (tmp == &m_no_value)
+        return m_no_value;
+    return std::move(*tmp);
+}
+
 inline void VM::swapStackForFunCall(uint16_t argc)
 {
     using namespace internal;
@@ -181,6 +223,8 @@ inline void VM::swapStackForFunCall(uint16_t argc)
             break;
 
         case 1:
+            if (m_sp + 2 > m_stack->committed())
+                growStack(m_sp + 2);
             (*m_stack)[m_sp + 1] = (*m_stack)[m_sp - 1];
             resolveRefInPlace((*m_stack)[m_sp + 1]);
             (*m_stack)[m_sp - 1] = Value(static_cast<PageAddr_t>(m_pp));
@@ -190,7 +234,10 @@ inline void VM::swapStackForFunCall(uint16_t argc)
 
         default:  // 2 or more elements
         {
-            const int16_t first = m_sp - argc;
+            if (m_sp + 2 > m_stack->committed())
+                growStack(m_sp + 2);
+
+            const std::size_t first = m_sp - argc;
             // move first argument to the very end
             (*m_stack)[m_sp + 1] = (*m_stack)[first + 0];
             resolveRefInPlace((*m_stack)[m_sp + 1]);
@@ -198,8 +245,8 @@ inline void VM::swapStackForFunCall(uint16_t argc)
             (*m_stack)[m_sp + 0] = (*m_stack)[first + 1];
             resolveRefInPlace((*m_stack)[m_sp + 0]);
             // move the rest, if any
-            int16_t x = 2;
-            const int16_t stop = ((argc % 2 == 0) ? argc : (argc - 1)) / 2;
+            std::size_t x = 2;
+            const std::size_t stop = ((argc % 2 == 0) ? argc : (argc - 1)) / 2;
             while (x <= stop)
             {
                 //        destination          , origin
@@ -219,23 +266,189 @@ inline void VM::swapStackForFunCall(uint16_t argc)
     m_scope_count_to_delete.emplace_back(0);
 }
 
+inline bool VM::tailCall(uint16_t argc)
+{
+    using namespace internal;
+
+    // no scope should have been pushed for this call (closure field), and the function must be on the stack
+    if (m_fc <= 1 || m_scope_count_to_delete.back() != 0 || m_sp < argc + 1u)
+        return false;
+
+    Value* function = &(*m_stack)[m_sp - 1];
+    if (function->valueType() == ValueType::Reference)
+        function = function->reference();
+    if (function->valueType() != ValueType::PageAddr || function->pageAddr() != m_pp ||
+        m_state->function(m_pp).arity != argc)
+        return false;
+
+    // find the return address of the current frame, below the arguments and the values left by the function
+    const std::size_t first_arg = m_sp - 1 - argc;
+    std::size_t frame = first_arg;
+    while (frame > 0 && (*m_stack)[frame - 1].valueType() != ValueType::InstPtr)
+        --frame;
+    if (frame == 0)
+        return false;
+
+    Value self = *function;
+    --m_sp;
+
+    // the arguments may reference variables of the scope we are about to reset
+    for (std::size_t i = first_arg; i < m_sp; ++i)
+        resolveRefInPlace((*m_stack)[i]);
+    // put them right above the return address, in the order given by swapStackForFunCall
+    std::reverse(m_stack->data() + first_arg, m_stack->data() + m_sp);
+    for (uint16_t i = 0; i < argc; ++i)
+        (*m_stack)[frame + i] = std::move((*m_stack)[first_arg + i]);
+    m_sp = frame + argc;
+
+    popScope();
+    createNewScope(m_state->function(m_pp).locals.size());
+    // store "reference" to the function to speed the recursive functions
+    if (m_last_sym_loaded < m_state->m_symbols.size())
+        m_locals.back()->push_back(m_last_sym_loaded, std::move(self));
+
+    return true;
+}
+
+inline void VM::checkStackRoom(internal::PageAddr_t pp)
+{
+    if (m_sp + m_state->function(pp).max_stack >= m_stack->capacity())
+        throwVMError("Maximum recursion depth exceeded, could not call '" + m_state->m_symbols[m_last_sym_loaded] + "': the stack is full");
+}
+
+inline void VM::growStack(std::size_t size)
+{
+    if (size > m_stack->capacity())
+        throwVMError("Stack overflow: more than " + std::to_string(m_stack->capacity()) + " values are needed on the stack");
+    m_stack->commit(size);
+}
+
+inline void VM::collectCycles()
+{
+    m_gc.collect(m_stack->data(), m_sp);
+    if (m_gc.overLimit())
+        throwVMError("Heap limit exceeded: " + std::to_string(m_gc.stats().tracked) + " closures environments are alive, the limit is " + std::to_string(m_gc.stats().limit));
+}
+
 #pragma endregion
 
-inline void VM::createNewScope() noexcept
+inline void VM::createNewScope(std::size_t slots) noexcept
+{
+    if (!m_scope_pool.empty())
+    {
+        m_locals.push_back(std::move(m_scope_pool.back()));
+        m_scope_pool.pop_back();
+        m_locals.back()->reset(slots);
+    }
+    else
+        m_locals.emplace_back(std::make_shared<internal::Scope>(slots));
+}
+
+inline void VM::popScope() noexcept
 {
-    m_locals.emplace_back(std::make_shared<internal::Scope>());
+    // a scope used by a closure or saved by SAVE_ENV is shared, and must stay alive
+    if (m_locals.back().use_count() == 1 && m_scope_pool.size() < ArkVMScopePoolSize)
+    {
+        // destroy the variables now, the storage is kept for the next frame
+        m_locals.back()->reset(0);
+        m_scope_pool.push_back(std::move(m_locals.back()));
+    }
+    m_locals.pop_back();
 }
 
 inline Value* VM::findNearestVariable(uint16_t id) noexcept
+{
+    if (internal::Scope::Binding* b = findNearestBinding(id); b != nullptr)
+        return &b->value;
+    return nullptr;
+}
+
+inline internal::Scope::Binding* VM::findNearestBinding(uint16_t id) noexcept
 {
     for (auto it = m_locals.rbegin(), it_end = m_locals.rend(); it != it_end; ++it)
     {
-        if (auto val = (**it)[id]; val != nullptr)
-            return val;
+        if (auto b = (*it)->binding(id); b != nullptr)
+            return b;
     }
     return nullptr;
 }
 
+inline internal::Scope::Binding* VM::findField(internal::Closure& closure, uint16_t id, uint16_t cache_id) noexcept
+{
+    using namespace internal;
+
+    Scope& scope = *closure.refScope();
+    FieldCache& cache = m_field_caches[cache_id];
+
+    // the id is checked as well, to be safe if a closure scope were modified
+    if (cache.page == closure.pageAddr() && cache.slot < scope.m_data.size() && scope.m_data[cache.slot].id == id)
+        return &scope.m_data[cache.slot];
+
+    for (std::size_t i = 0, end = scope.m_data.size(); i < end; ++i)
+    {
+        if (scope.m_data[i].id == id)
+        {
+            cache.page = closure.pageAddr();
+            cache.slot = static_cast<uint16_t>(i);
+            return &scope.m_data[i];
+        }
+    }
+    return nullptr;
+}
+
+inline Value* VM::constant(uint16_t id) const noexcept
+{
+    // references need a non-const pointer, the constness is carried by the reference itself
+    return const_cast<Value*>(&m_state->m_constants[id]);
+}
+
+inline Value* VM::loadOperand(const internal::DecodedInstruction& inst)
+{
+    using namespace internal;
+
+    if (inst.unfused == Instruction::LOAD_CONST)
+        return constant(inst.arg);
+
+    // LOAD_SYMBOL or LOAD_LOCAL
+    m_last_sym_loaded = inst.unfused == Instruction::LOAD_LOCAL ? inst.extra : inst.arg;
+
+    Scope::Binding* var = nullptr;
+    if (Scope& frame = *m_locals.back(); inst.unfused == Instruction::LOAD_LOCAL && inst.arg < frame.m_data.size() && frame.m_data[inst.arg].id == inst.extra)
+        var = &frame.m_data[inst.arg];
+    else
+        var = findNearestBinding(m_last_sym_loaded);
+
+    if (var == nullptr)
+        throwVMError("unbound variable: " + m_state->m_symbols[m_last_sym_loaded]);
+    return &var->value;
+}
+
+inline internal::Scope::Binding* VM::findStoreTarget(const internal::DecodedInstruction& inst)
+{
+    using namespace internal;
+
+    // STORE or STORE_LOCAL
+    uint16_t id = inst.unfused == Instruction::STORE_LOCAL ? inst.extra : inst.arg;
+
+    Scope::Binding* var = nullptr;
+    if (Scope& frame = *m_locals.back(); inst.unfused == Instruction::STORE_LOCAL && inst.arg < frame.m_data.size() && frame.m_data[inst.arg].id == id)
+        var = &frame.m_data[inst.arg];
+    else
+        var = findNearestBinding(id);
+
+    if (var == nullptr)
+        throwVMError("unbound variable " + m_state->m_symbols[id] + ", can not change its value");
+    if (var->is_const)
+        throwVMError("can not modify a constant: " + m_state->m_symbols[id]);
+
+    return var;
+}
+
+inline const internal::DecodedInstruction* VM::codePage(std::size_t pp) const noexcept
+{
+    return m_state->m_code.data() + m_state->m_pages_offsets[pp];
+}
+
 inline void VM::returnFromFuncCall()
 {
     COZ_BEGIN("ark vm returnFromFuncCall");
@@ -245,21 +458,16 @@ inline void VM::returnFromFuncCall()
     m_scope_count_to_delete.pop_back();
     uint8_t del_counter = m_scope_count_to_delete.back();
 
-    // PERF high cpu cost because destroying variants cost
-    m_locals.pop_back();
+    popScope();
 
     while (del_counter != 0)
     {
-        m_locals.pop_back();
+        popScope();
         del_counter--;
     }
 
     m_scope_count_to_delete.back() = 0;
 
-    // stop the executing if we reach the wanted frame count
-    if (m_fc == m_until_frame_count)
-        m_running = false;
-
     COZ_END("ark vm returnFromFuncCall");
 }
 
@@ -280,11 +488,7 @@ inline void VM::call(int16_t argc_)
 
     // handling calls from C++ code
     if (argc_ <= -1)
-    {
-        ++m_ip;
-        argc = (static_cast<uint16_t>(m_state->m_pages[m_pp][m_ip]) << 8) + static_cast<uint16_t>(m_state->m_pages[m_pp][m_ip + 1]);
-        ++m_ip;
-    }
+        argc = codePage(m_pp)[m_ip].arg;
     else
         argc = argc_;
 
@@ -294,24 +498,17 @@ inline void VM::call(int16_t argc_)
     {
         // is it a builtin function name?
         case ValueType::CProc:
-        {
-            // drop arguments from the stack
-            std::vector<Value> args(argc);
-            for (uint16_t j = 0; j < argc; ++j)
-                args[argc - 1 - j] = *popAndResolveAsPtr();
-
-            // call proc
-            push(function.proc()(args, this));
+            callProc(function, argc);
             return;
-        }
 
         // is it a user defined function?
         case ValueType::PageAddr:
         {
             PageAddr_t new_page_pointer = function.pageAddr();
 
-            // create dedicated frame
-            createNewScope();
+            checkStackRoom(new_page_pointer);
+            // create dedicated frame, with a slot for each local variable
+            createNewScope(m_state->function(new_page_pointer).locals.size());
 
             swapStackForFunCall(argc);
 
@@ -329,11 +526,12 @@ inline void VM::call(int16_t argc_)
         {
             Closure& c = function.refClosure();
             PageAddr_t new_page_pointer = c.pageAddr();
+            checkStackRoom(new_page_pointer);
 
             // load saved scope
             m_locals.push_back(c.scope());
-            // create dedicated frame
-            createNewScope();
+            // create dedicated frame, with a slot for each local variable
+            createNewScope(m_state->function(new_page_pointer).locals.size());
             ++m_scope_count_to_delete.back();
 
             swapStackForFunCall(argc);
@@ -348,16 +546,7 @@ inline void VM::call(int16_t argc_)
     }
 
     // checking function arity
-    std::size_t index = 0,
-                needed_argc = 0;
-
-    // every argument is a MUT declaration in the bytecode
-    while (m_state->m_pages[m_pp][index] == Instruction::MUT)
-    {
-        needed_argc += 1;
-        index += 3;  // jump the argument of MUT (integer on 2 bits, big endian)
-    }
-
+    uint16_t needed_argc = m_state->function(m_pp).arity;
     if (needed_argc != argc)
         throwVMError(
             "Function '" + m_state->m_symbols[m_last_sym_loaded] + "' needs " + std::to_string(needed_argc) +
@@ -366,5 +555,212 @@ inline void VM::call(int16_t argc_)
     COZ_END("ark vm::call");
 }
 
+inline void VM::callProc(const Value& function, uint16_t argc)
+{
+    // the arguments stay on the stack during the call, so that a nested safeRun
+    // (VM::call / VM::resolve) pushes its values above them
+    ArgsView args(&(*m_stack)[m_sp - argc], argc);
+    Value result;
+    if (function.isLegacyProc())
+    {
+        std::vector<Value> copy = args.toVector();
+        result = function.legacyProc()(copy, this);
+    }
+    else
+        result = function.proc()(args, this);
+
+    // drop arguments from the stack
+    m_sp -= argc;
+    push(std::move(result));
+}
+
+#pragma region "operators"
+
+template <uint8_t Op>
+inline Value VM::binaryOperator(Value* a, Value* b)
+{
+    using namespace internal;
+
+    if constexpr (Op == Instruction::ADD)
+    {
+        if (a->valueType() == ValueType::Number)
+        {
+            if (b->valueType() != ValueType::Number)
+                throw BetterTypeError("+", 2, { *a, *b })
+                    .withArg("a", ValueType::Number)
+                    .withArg("b", ValueType::Number);
+
+            return Value(a->number() + b->number());
+        }
+        else if (a->valueType() == ValueType::String)
+        {
+            if (b->valueType() != ValueType::String)
+                throw BetterTypeError("+", 2, { *a, *b })
+                    .withArg("a", ValueType::String)
+                    .withArg("b", ValueType::String);
+
+            return Value(a->string() + b->string());
+        }
+        throw BetterTypeError("+", 2, { *a, *b })
+            .withArg("a", { ValueType::Number, ValueType::String })
+            .withArg("b", { ValueType::Number, ValueType::String });
+    }
+    else if constexpr (Op == Instruction::SUB || Op == Instruction::MUL || Op == Instruction::DIV)
+    {
+        constexpr const char* name = Op == Instruction::SUB ? "-" : (Op == Instruction::MUL ? "*" : "/");
+
+        if (a->valueType() != ValueType::Number || b->valueType() != ValueType::Number)
+            throw BetterTypeError(name, 2, { *a, *b })
+                .withArg("a", ValueType::Number)
+                .withArg("b", ValueType::Number);
+
+        if constexpr (Op == Instruction::SUB)
+            return Value(a->number() - b->number());
+        else if constexpr (Op == Instruction::MUL)
+            return Value(a->number() * b->number());
+        else
+        {
+            auto d = b->number();
+            if (d == 0)
+                throw ZeroDivisionError();
+
+            return Value(a->number() / d);
+        }
+    }
+    else if constexpr (Op == Instruction::MOD)
+    {
+        if (a->valueType() != ValueType::Number)
+            throw TypeError("Arguments of mod should be Numbers");
+        if (b->valueType() != ValueType::Number)
+            throw TypeError("Arguments of mod should be Numbers");
+
+        return Value(std::fmod(a->number(), b->number()));
+    }
+    else
+        return compare<Op>(a, b) ? Builtins::trueSym : Builtins::falseSym;
+}
+
+inline Value VM::binaryOperator(uint8_t op, Value* a, Value* b)
+{
+    using namespace internal;
+
+    switch (op)
+    {
+        case Instruction::ADD: return binaryOperator<Instruction::ADD>(a, b);
+        case Instruction::SUB: return binaryOperator<Instruction::SUB>(a, b);
+        case Instruction::MUL: return binaryOperator<Instruction::MUL>(a, b);
+        case Instruction::DIV: return binaryOperator<Instruction::DIV>(a, b);
+        case Instruction::MOD: return binaryOperator<Instruction::MOD>(a, b);
+        default:
+            return compare(op, a, b) ? Builtins::trueSym : Builtins::falseSym;
+    }
+}
+
+template <uint8_t Op>
+inline bool VM::compare(const Value* a, const Value* b)
+{
+    using namespace internal;
+
+    if constexpr (Op == Instruction::GT)
+        return !(*a == *b) && !(*a < *b);
+    else if constexpr (Op == Instruction::LT)
+        return *a < *b;
+    else if constexpr (Op == Instruction::LE)
+        return (*a < *b) || (*a == *b);
+    else if constexpr (Op == Instruction::GE)
+        return !(*a < *b);
+    else if constexpr (Op == Instruction::NEQ)
+        return *a != *b;
+    else
+    {
+        static_assert(Op == Instruction::EQ, "unknown comparison operator");
+        return *a == *b;
+    }
+}
+
+inline bool VM::compare(uint8_t op, const Value* a, const Value* b)
+{
+    using namespace internal;
+
+    switch (op)
+    {
+        case Instruction::GT: return compare<Instruction::GT>(a, b);
+        case Instruction::LT: return compare<Instruction::LT>(a, b);
+        case Instruction::LE: return compare<Instruction::LE>(a, b);
+        case Instruction::GE: return compare<Instruction::GE>(a, b);
+        case Instruction::NEQ: return compare<Instruction::NEQ>(a, b);
+        default: return compare<Instruction::EQ>(a, b);
+    }
+}
+
+inline void VM::quicken(uint8_t& op, const Value* a, const Value* b) noexcept
+{
+    // an operator which had to go back to its generic version too many times is used on multiple types, leave it generic
+    if (a->valueType() == ValueType::Number && b->valueType() == ValueType::Number && op < MaxDeoptimizations)
+        op |= QuickenedOperator;
+}
+
+template <uint8_t Op>
+inline void VM::numberOperator(uint8_t& op)
+{
+    using namespace internal;
+
+    if (m_sp >= 2)
+    {
+        // read the operands in place, the result replaces the first one
+        Value* slot = &(*m_stack)[m_sp - 2];
+        const Value* a = slot[0].valueType() == ValueType::Reference ? slot[0].reference() : &slot[0];
+        const Value* b = slot[1].valueType() == ValueType::Reference ? slot[1].reference() : &slot[1];
+
+        if (a->valueType() == ValueType::Number && b->valueType() == ValueType::Number)
+        {
+            double x = a->number(), y = b->number();
+            --m_sp;
+
+            // same results as binaryOperator and compare, including for NaN
+            if constexpr (Op == Instruction::ADD)
+                slot[0] = Value(x + y);
+            else if constexpr (Op == Instruction::SUB)
+                slot[0] = Value(x - y);
+            else if constexpr (Op == Instruction::MUL)
+                slot[0] = Value(x * y);
+            else if constexpr (Op == Instruction::DIV)
+            {
+                if (y == 0)
+                    throw ZeroDivisionError();
+                slot[0] = Value(x / y);
+            }
+            else
+            {
+                bool result;
+                if constexpr (Op == Instruction::GT)
+                    result = !(x == y) && !(x < y);
+                else if constexpr (Op == Instruction::LT)
+                    result = x < y;
+                else if constexpr (Op == Instruction::LE)
+                    result = (x < y) || (x == y);
+                else if constexpr (Op == Instruction::GE)
+                    result = !(x < y);
+                else if constexpr (Op == Instruction::NEQ)
+                    result = x != y;
+                else
+                {
+                    static_assert(Op == Instruction::EQ, "unknown operator");
+                    result = x == y;
+                }
+                slot[0] = result ? Builtins::trueSym : Builtins::falseSym;
+            }
+            return;
+        }
+    }
+
+    // deoptimize
+    op = static_cast<uint8_t>((op & ~QuickenedOperator) + 1);
+    Value *b = popAndResolveAsPtr(), *a = popAndResolveAsPtr();
+    push(binaryOperator<Op>(a, b));
+}
+
+#pragma endregion
+
 #undef resolveRef
 #undef resolveRefInPlace
@@ -1,9 +1,68 @@
+// copy and destruction
+
+inline Value::Value(const Value& other) noexcept :
+    m_bits(other.m_bits)
+{
+    if (isHeapObject())
+        acquire();
+
+#ifdef ARK_PROFILER_COUNT
+    if (valueType() != ValueType::Reference)
+        value_copies++;
+#endif
+}
+
+inline Value::Value(Value&& other) noexcept :
+    m_bits(other.m_bits)
+{
+    other.m_bits = box(ValueType::Undefined, 0);
+
+#ifdef ARK_PROFILER_COUNT
+    if (valueType() != ValueType::Reference)
+        value_moves++;
+#endif
+}
+
+inline Value& Value::operator=(const Value& other) noexcept
+{
+    if (this != &other)
+    {
+        // take the new reference before dropping ours, in case we hold a parent of other
+        Value tmp(other);
+        std::swap(m_bits, tmp.m_bits);
+    }
+    return *this;
+}
+
+inline Value& Value::operator=(Value&& other) noexcept
+{
+    if (this != &other)
+    {
+        Value tmp(std::move(other));
+        std::swap(m_bits, tmp.m_bits);
+    }
+    return *this;
+}
+
+inline Value::~Value()
+{
+    if (isHeapObject())
+        release();
+}
+
+inline bool Value::isHeapObject() const noexcept
+{
+    return m_bits >= BoxedBase && ((HeapTypes >> ((m_bits - BoxedBase) >> 48)) & 1);
+}
+
 // public getters
 
 inline ValueType Value::valueType() const noexcept
 {
-    // the type is stored on the right most bits
-    return static_cast<ValueType>(m_const_type & (0b01111111));
+    // everything under the boxed values is a number
+    if (m_bits < BoxedBase)
+        return ValueType::Number;
+    return static_cast<ValueType>((m_bits - BoxedBase) >> 48);
 }
 
 inline bool Value::isFunction() const noexcept  // if it's a function we can resolve it
@@ -15,52 +74,68 @@ inline bool Value::isFunction() const noexcept  // if it's a function we can res
 
 inline double Value::number() const
 {
-    return std::get<double>(m_value);
+    double d;
+    std::memcpy(&d, &m_bits, sizeof(double));
+    return d;
 }
 
 inline const String& Value::string() const
 {
-    return std::get<String>(m_value);
+    return boxed<String>();
 }
 
-inline const std::vector<Value>& Value::constList() const
+inline const internal::ListStorage& Value::constList() const
 {
-    return std::get<std::vector<Value>>(m_value);
+    return boxed<internal::ListStorage>();
 }
 
 inline const UserType& Value::usertype() const
 {
-    return std::get<UserType>(m_value);
+    return boxed<UserType>();
+}
+
+inline Value* Value::reference() const
+{
+    // the right most bit of the pointer is used to store the constness
+    return reinterpret_cast<Value*>(m_bits & PayloadMask & ~static_cast<uint64_t>(1));
 }
 
 // private getters
 
 inline internal::PageAddr_t Value::pageAddr() const
 {
-    return std::get<internal::PageAddr_t>(m_value);
+    return static_cast<internal::PageAddr_t>(m_bits & PayloadMask);
+}
+
+inline Value::ProcType Value::proc() const
+{
+    return reinterpret_cast<ProcType>(m_bits & PayloadMask);
+}
+
+inline bool Value::isLegacyProc() const noexcept
+{
+    return (m_bits & LegacyProcFlag) != 0;
 }
 
-inline const Value::ProcType& Value::proc() const
+inline Value::LegacyProcType Value::legacyProc() const
 {
-    return std::get<Value::ProcType>(m_value);
+    return reinterpret_cast<LegacyProcType>(m_bits & PayloadMask & ~LegacyProcFlag);
 }
 
 inline const internal::Closure& Value::closure() const
 {
-    return std::get<internal::Closure>(m_value);
+    return boxed<internal::Closure>();
 }
 
 inline bool Value::isConst() const noexcept
 {
-    return m_const_type & (1 << 7);
+    return valueType() == ValueType::Reference && (m_bits & 1);
 }
 
 inline void Value::setConst(bool value) noexcept
 {
-    if (value)
-        m_const_type |= 1 << 7;
-    else
-        m_const_type &= 0b01111111;  // keep only the right most bits
+    if (valueType() == ValueType::Reference)
+        m_bits = value ? (m_bits | 1) : (m_bits & ~static_cast<uint64_t>(1));
 }
 
 // operators
@@ -70,18 +145,81 @@ inline bool operator==(const Value& A, const Value& B) noexcept
     // values should have the same type
     if (A.valueType() != B.valueType())
         return false;
-    // all the types >= Nil are Nil itself, True, False, Undefined
-    else if ((A.m_const_type & 0b01111111) >= static_cast<int>(ValueType::Nil))
-        return true;
 
-    return A.m_value == B.m_value;
+    switch (A.valueType())
+    {
+        case ValueType::Number:
+            return A.number() == B.number();
+
+        case ValueType::String:
+        {
+            auto a = A.payloadAs<internal::ValueBox<String>>();
+            auto b = B.payloadAs<internal::ValueBox<String>>();
+            // shared strings are equal, interned strings with different hashes are different
+            if (a == b)
+                return true;
+            if (a->hash != b->hash && a->hash != 0 && b->hash != 0)
+                return false;
+            return a->data == b->data;
+        }
+
+        case ValueType::List:
+        {
+            const internal::ListStorage& a = A.constList();
+            const internal::ListStorage& b = B.constList();
+            return &a == &b || (a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin()));
+        }
+
+        case ValueType::Closure:
+            return A.closure() == B.closure();
+
+        case ValueType::User:
+            return A.usertype() == B.usertype();
+
+        case ValueType::Reference:
+            return A.reference() == B.reference();
+
+        // all the types >= Nil are Nil itself, True, False, Undefined
+        case ValueType::Nil:
+        case ValueType::True:
+        case ValueType::False:
+        case ValueType::Undefined:
+            return true;
+
+        // page addresses, instruction pointers and C++ functions are stored in the payload
+        default:
+            return A.m_bits == B.m_bits;
+    }
 }
 
 inline bool operator<(const Value& A, const Value& B) noexcept
 {
     if (A.valueType() != B.valueType())
         return (static_cast<int>(A.valueType()) - static_cast<int>(B.valueType())) < 0;
-    return A.m_value < B.m_value;
+
+    switch (A.valueType())
+    {
+        case ValueType::Number:
+            return A.number() < B.number();
+
+        case ValueType::String:
+            return A.string() < B.string();
+
+        case ValueType::List:
+            return std::lexicographical_compare(A.constList().begin(), A.constList().end(), B.constList().begin(), B.constList().end());
+
+        case ValueType::Closure:
+            return A.closure() < B.closure();
+
+        case ValueType::User:
+            return A.usertype() < B.usertype();
+
+        case ValueType::Reference:
+            return A.reference() < B.reference();
+
+        default:
+            return A.m_bits < B.m_bits;
+    }
 }
 
 inline bool operator!=(const Value& A, const Value& B) noexcept
@@ -94,7 +232,7 @@ inline bool operator!(const Value& A) noexcept
     switch (A.valueType())
     {
         case ValueType::List:
-            return A.constList().empty();
+            return A.constList().size() == 0;
 
         case ValueType::Number:
             return !A.number();
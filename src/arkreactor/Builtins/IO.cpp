@@ -20,10 +20,10 @@ namespace Ark::internal::Builtins::IO
      * =end
      * @author https://github.com/SuperFola
      */
-    Value print(std::vector<Value>& n, Ark::VM* vm [[maybe_unused]])
+    Value print(ArgsView n, Ark::VM* vm [[maybe_unused]])
     {
-        for (Value::Iterator it = n.begin(), it_end = n.end(); it != it_end; ++it)
-            std::cout << (*it);
+        for (std::size_t i = 0, end = n.size(); i < end; ++i)
+            std::cout << n[i];
         std::cout << '\n';
 
         return nil;
@@ -39,10 +39,10 @@ namespace Ark::internal::Builtins::IO
      * =end
      * @author https://github.com/SuperFola
      */
-    Value puts_(std::vector<Value>& n, Ark::VM* vm [[maybe_unused]])
+    Value puts_(ArgsView n, Ark::VM* vm [[maybe_unused]])
     {
-        for (Value::Iterator it = n.begin(), it_end = n.end(); it != it_end; ++it)
-            std::cout << (*it);
+        for (std::size_t i = 0, end = n.size(); i < end; ++i)
+            std::cout << n[i];
 
         return nil;
     }
@@ -57,7 +57,7 @@ namespace Ark::internal::Builtins::IO
      * =end
      * @author https://github.com/SuperFola
      */
-    Value input(std::vector<Value>& n, Ark::VM* vm [[maybe_unused]])
+    Value input(ArgsView n, Ark::VM* vm [[maybe_unused]])
     {
         if (n.size() == 1)
         {
@@ -84,7 +84,7 @@ namespace Ark::internal::Builtins::IO
      * =end
      * @author https://github.com/SuperFola
      */
-    Value writeFile(std::vector<Value>& n, Ark::VM* vm [[maybe_unused]])
+    Value writeFile(ArgsView n, Ark::VM* vm [[maybe_unused]])
     {
         // filename, content
         if (n.size() == 2)
@@ -99,7 +99,7 @@ namespace Ark::internal::Builtins::IO
                 f.close();
             }
             else
-                throw std::runtime_error("Couldn't write to file \"" + n[0].stringRef().toString() + "\"");
+                throw std::runtime_error("Couldn't write to file \"" + n[0].string().toString() + "\"");
         }
         // filename, mode (a or w), content
         else if (n.size() == 3)
@@ -124,7 +124,7 @@ namespace Ark::internal::Builtins::IO
                 f.close();
             }
             else
-                throw std::runtime_error("Couldn't write to file \"" + n[0].stringRef().toString() + "\"");
+                throw std::runtime_error("Couldn't write to file \"" + n[0].string().toString() + "\"");
         }
         else
             throw std::runtime_error(IO_WRITE_ARITY);
@@ -140,7 +140,7 @@ namespace Ark::internal::Builtins::IO
      * =end
      * @author https://github.com/SuperFola
      */
-    Value readFile(std::vector<Value>& n, Ark::VM* vm [[maybe_unused]])
+    Value readFile(ArgsView n, Ark::VM* vm [[maybe_unused]])
     {
         if (n.size() != 1)
             throw std::runtime_error(IO_READ_ARITY);
@@ -163,7 +163,7 @@ namespace Ark::internal::Builtins::IO
      * =end
      * @author https://github.com/SuperFola
      */
-    Value fileExists(std::vector<Value>& n, Ark::VM* vm [[maybe_unused]])
+    Value fileExists(ArgsView n, Ark::VM* vm [[maybe_unused]])
     {
         if (n.size() != 1)
             throw std::runtime_error(IO_EXISTS_ARITY);
@@ -182,7 +182,7 @@ namespace Ark::internal::Builtins::IO
      * =end
      * @author https://github.com/SuperFola
      */
-    Value listFiles(std::vector<Value>& n, Ark::VM* vm [[maybe_unused]])
+    Value listFiles(ArgsView n, Ark::VM* vm [[maybe_unused]])
     {
         if (n.size() != 1)
             throw std::runtime_error(IO_LS_ARITY);
@@ -205,7 +205,7 @@ namespace Ark::internal::Builtins::IO
      * =end
      * @author https://github.com/SuperFola
      */
-    Value isDirectory(std::vector<Value>& n, Ark::VM* vm [[maybe_unused]])
+    Value isDirectory(ArgsView n, Ark::VM* vm [[maybe_unused]])
     {
         if (n.size() != 1)
             throw std::runtime_error(IO_ISDIR_ARITY);
@@ -224,7 +224,7 @@ namespace Ark::internal::Builtins::IO
      * =end
      * @author https://github.com/SuperFola
      */
-    Value makeDir(std::vector<Value>& n, Ark::VM* vm [[maybe_unused]])
+    Value makeDir(ArgsView n, Ark::VM* vm [[maybe_unused]])
     {
         if (n.size() != 1)
             throw std::runtime_error(IO_MKD_ARITY);
@@ -245,16 +245,16 @@ namespace Ark::internal::Builtins::IO
      * =end
      * @author https://github.com/SuperFola
      */
-    Value removeFiles(std::vector<Value>& n, Ark::VM* vm [[maybe_unused]])
+    Value removeFiles(ArgsView n, Ark::VM* vm [[maybe_unused]])
     {
         if (n.size() == 0)
             throw std::runtime_error(IO_RM_ARITY);
 
-        for (Value::Iterator it = n.begin(), it_end = n.end(); it != it_end; ++it)
+        for (std::size_t i = 0, end = n.size(); i < end; ++i)
         {
-            if (it->valueType() != ValueType::String)
+            if (n[i].valueType() != ValueType::String)
                 throw Ark::TypeError(IO_RM_TE0);
-            std::filesystem::remove_all(std::filesystem::path(it->string().c_str()));
+            std::filesystem::remove_all(std::filesystem::path(n[i].string().c_str()));
         }
 
         return nil;
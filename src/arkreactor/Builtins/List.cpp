@@ -18,16 +18,17 @@ namespace Ark::internal::Builtins::List
      * =end
      * @author https://github.com/SuperFola
      */
-    Value reverseList(std::vector<Value>& n, Ark::VM* vm [[maybe_unused]])
+    Value reverseList(ArgsView n, Ark::VM* vm [[maybe_unused]])
     {
-        if (n[0].valueType() != ValueType::List)
-            throw Ark::TypeError(LIST_REVERSE_ARITY);
         if (n.size() != 1)  // arity error
+            throw std::runtime_error(LIST_REVERSE_ARITY);
+        if (n[0].valueType() != ValueType::List)
             throw Ark::TypeError(LIST_REVERSE_TE0);
 
-        std::reverse(n[0].list().begin(), n[0].list().end());
+        Value list = n.take(0);
+        std::reverse(list.list().begin(), list.list().end());
 
-        return n[0];
+        return list;
     }
 
     /**
@@ -42,18 +43,18 @@ namespace Ark::internal::Builtins::List
      * =end
      * @author https://github.com/SuperFola
      */
-    Value findInList(std::vector<Value>& n, Ark::VM* vm [[maybe_unused]])
+    Value findInList(ArgsView n, Ark::VM* vm [[maybe_unused]])
     {
         if (n.size() != 2)
             throw std::runtime_error(LIST_FIND_ARITY);
         if (n[0].valueType() != ValueType::List)
             throw Ark::TypeError(LIST_FIND_TE0);
 
-        std::vector<Value>& l = n[0].list();
-        for (Value::Iterator it = l.begin(), it_end = l.end(); it != it_end; ++it)
+        const internal::ListStorage& l = n[0].constList();
+        for (std::size_t i = 0, size = l.size(); i < size; ++i)
         {
-            if (*it == n[1])
-                return Value(static_cast<int>(std::distance<Value::Iterator>(l.begin(), it)));
+            if (l[i] == n[1])
+                return Value(static_cast<int>(i));
         }
 
         return Value(-1);
@@ -71,7 +72,7 @@ namespace Ark::internal::Builtins::List
      * =end
      * @author https://github.com/SuperFola
      */
-    Value removeAtList(std::vector<Value>& n, Ark::VM* vm [[maybe_unused]])
+    Value removeAtList(ArgsView n, Ark::VM* vm [[maybe_unused]])
     {
         static bool has_warned = false;
         if (!has_warned)
@@ -88,11 +89,12 @@ namespace Ark::internal::Builtins::List
             throw Ark::TypeError(LIST_RMAT_TE1);
 
         std::size_t idx = static_cast<std::size_t>(n[1].number());
-        if (idx >= n[0].list().size())
+        if (idx >= n[0].constList().size())
             throw std::runtime_error(LIST_RMAT_OOR);
 
-        n[0].list().erase(n[0].list().begin() + idx);
-        return n[0];
+        Value list = n.take(0);
+        list.list().erase(list.list().begin() + idx);
+        return list;
     }
 
     /**
@@ -108,7 +110,7 @@ namespace Ark::internal::Builtins::List
      * =end
      * @author https://github.com/SuperFola
      */
-    Value sliceList(std::vector<Value>& n, Ark::VM* vm [[maybe_unused]])
+    Value sliceList(ArgsView n, Ark::VM* vm [[maybe_unused]])
     {
         if (n.size() != 4)
             throw std::runtime_error(LIST_SLICE_ARITY);
@@ -130,12 +132,13 @@ namespace Ark::internal::Builtins::List
 
         if (start > end)
             throw std::runtime_error(LIST_SLICE_ORDER);
-        if (start < 0 || static_cast<std::size_t>(end) > n[0].list().size())
+        const internal::ListStorage& list = n[0].constList();
+        if (start < 0 || static_cast<std::size_t>(end) > list.size())
             throw std::runtime_error(LIST_SLICE_OOR);
 
         std::vector<Value> retlist;
         for (long i = start; i < end; i += step)
-            retlist.push_back(n[0].list()[i]);
+            retlist.push_back(list[i]);
 
         return Value(std::move(retlist));
     }
@@ -150,15 +153,16 @@ namespace Ark::internal::Builtins::List
      * =end
      * @author https://github.com/SuperFola
      */
-    Value sort_(std::vector<Value>& n, Ark::VM* vm [[maybe_unused]])
+    Value sort_(ArgsView n, Ark::VM* vm [[maybe_unused]])
     {
         if (n.size() != 1)
             throw std::runtime_error(LIST_SORT_ARITY);
         if (n[0].valueType() != ValueType::List)
             throw Ark::TypeError(LIST_SORT_TE0);
 
-        std::sort(n[0].list().begin(), n[0].list().end());
-        return n[0];
+        Value list = n.take(0);
+        std::sort(list.list().begin(), list.list().end());
+        return list;
     }
 
     /**
@@ -171,7 +175,7 @@ namespace Ark::internal::Builtins::List
      * =end
      * @author https://github.com/SuperFola
      */
-    Value fill(std::vector<Value>& n, Ark::VM* vm [[maybe_unused]])
+    Value fill(ArgsView n, Ark::VM* vm [[maybe_unused]])
     {
         if (n.size() != 2)
             throw std::runtime_error(LIST_FILL_ARITY);
@@ -198,7 +202,7 @@ namespace Ark::internal::Builtins::List
      * =end
      * @author https://github.com/SuperFola
      */
-    Value setListAt(std::vector<Value>& n, Ark::VM* vm [[maybe_unused]])
+    Value setListAt(ArgsView n, Ark::VM* vm [[maybe_unused]])
     {
         if (n.size() != 3)
             throw std::runtime_error(LIST_SETAT_ARITY);
@@ -207,7 +211,9 @@ namespace Ark::internal::Builtins::List
         if (n[1].valueType() != ValueType::Number)
             throw Ark::TypeError(LIST_SETAT_TE1);
 
-        n[0].list()[static_cast<std::size_t>(n[1].number())] = n[2];
-        return n[0];
+        std::size_t idx = static_cast<std::size_t>(n[1].number());
+        Value list = n.take(0);
+        list.setAt(idx, n.take(2));
+        return list;
     }
 }
@@ -24,42 +24,44 @@ namespace Ark::internal::Builtins::String
      * =end
      * @author https://github.com/SuperFola
      */
-    Value format(std::vector<Value>& n, Ark::VM* vm [[maybe_unused]])
+    Value format(ArgsView n, Ark::VM* vm [[maybe_unused]])
     {
         if (n.size() == 0)
             throw std::runtime_error(STR_FORMAT_ARITY);
         if (n[0].valueType() != ValueType::String)
             throw Ark::TypeError(STR_FORMAT_TE0);
 
-        ::String f(n[0].string().c_str());
+        Value result = n.take(0);
+        ::String& f = result.stringRef();
 
-        for (Value::Iterator it = n.begin() + 1, it_end = n.end(); it != it_end; ++it)
+        for (std::size_t i = 1, end = n.size(); i < end; ++i)
         {
-            if (it->valueType() == ValueType::String)
+            const Value& arg = n[i];
+
+            if (arg.valueType() == ValueType::String)
             {
-                ::String& obj = it->stringRef();
+                const ::String& obj = arg.string();
                 f.format(f.size() + obj.size(), obj.c_str());
             }
-            else if (it->valueType() == ValueType::Number)
+            else if (arg.valueType() == ValueType::Number)
             {
-                double obj = it->number();
+                double obj = arg.number();
                 f.format(f.size() + Utils::digPlaces(obj) + Utils::decPlaces(obj) + 1, obj);
             }
-            else if (it->valueType() == ValueType::Nil)
+            else if (arg.valueType() == ValueType::Nil)
                 f.format(f.size() + 5, std::string_view("nil"));
-            else if (it->valueType() == ValueType::True)
+            else if (arg.valueType() == ValueType::True)
                 f.format(f.size() + 5, std::string_view("true"));
-            else if (it->valueType() == ValueType::False)
+            else if (arg.valueType() == ValueType::False)
                 f.format(f.size() + 5, std::string_view("false"));
             else
             {
                 std::stringstream ss;
-                ss << (*it);
+                ss << arg;
                 f.format(f.size() + ss.str().size(), std::string_view(ss.str().c_str()));
             }
         }
-        n[0].stringRef() = f;
-        return n[0];
+        return result;
     }
 
     /**
@@ -74,7 +76,7 @@ namespace Ark::internal::Builtins::String
      * =end
      * @author https://github.com/SuperFola
      */
-    Value findSubStr(std::vector<Value>& n, Ark::VM* vm [[maybe_unused]])
+    Value findSubStr(ArgsView n, Ark::VM* vm [[maybe_unused]])
     {
         if (n.size() != 2)
             throw std::runtime_error(STR_FIND_ARITY);
@@ -83,7 +85,7 @@ namespace Ark::internal::Builtins::String
         if (n[1].valueType() != ValueType::String)
             throw Ark::TypeError(STR_FIND_TE1);
 
-        return Value(n[0].stringRef().find(n[1].stringRef()));
+        return Value(n[0].string().find(n[1].string()));
     }
 
     /**
@@ -98,7 +100,7 @@ namespace Ark::internal::Builtins::String
      * =end
      * @author https://github.com/SuperFola
      */
-    Value removeAtStr(std::vector<Value>& n, Ark::VM* vm [[maybe_unused]])
+    Value removeAtStr(ArgsView n, Ark::VM* vm [[maybe_unused]])
     {
         if (n.size() != 2)
             throw std::runtime_error(STR_RM_ARITY);
@@ -108,11 +110,12 @@ namespace Ark::internal::Builtins::String
             throw Ark::TypeError(STR_RM_TE1);
 
         long id = static_cast<long>(n[1].number());
-        if (id < 0 || static_cast<std::size_t>(id) >= n[0].stringRef().size())
+        if (id < 0 || static_cast<std::size_t>(id) >= n[0].string().size())
             throw std::runtime_error(STR_RM_OOR);
 
-        n[0].stringRef().erase(id, id + 1);
-        return n[0];
+        Value str = n.take(0);
+        str.stringRef().erase(id, id + 1);
+        return str;
     }
 
     /**
@@ -125,14 +128,14 @@ namespace Ark::internal::Builtins::String
      * =end
      * @author https://github.com/SuperFola
      */
-    Value ord(std::vector<Value>& n, Ark::VM* vm [[maybe_unused]])
+    Value ord(ArgsView n, Ark::VM* vm [[maybe_unused]])
     {
         if (n.size() != 1)
             throw std::runtime_error(STR_ORD_ARITY);
         if (n[0].valueType() != ValueType::String)
             throw Ark::TypeError(STR_ORD_TE0);
 
-        int ord = utf8codepoint(n[0].stringRef().c_str());
+        int ord = utf8codepoint(n[0].string().c_str());
 
         return Value(ord);
     }
@@ -147,7 +150,7 @@ namespace Ark::internal::Builtins::String
      * =end
      * @author https://github.com/SuperFola
      */
-    Value chr(std::vector<Value>& n, Ark::VM* vm [[maybe_unused]])
+    Value chr(ArgsView n, Ark::VM* vm [[maybe_unused]])
     {
         if (n.size() != 1)
             throw std::runtime_error(STR_CHR_ARITY);
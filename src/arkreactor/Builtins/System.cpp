@@ -29,7 +29,7 @@ namespace Ark::internal::Builtins::System
      * =end
      * @author https://github.com/SuperFola
      */
-    Value system_(std::vector<Value>& n, Ark::VM* vm [[maybe_unused]])
+    Value system_(ArgsView n, Ark::VM* vm [[maybe_unused]])
     {
         if (n.size() != 1)
             throw std::runtime_error(SYS_SYS_ARITY);
@@ -60,7 +60,7 @@ namespace Ark::internal::Builtins::System
      * =end
      * @author https://github.com/SuperFola
      */
-    Value sleep(std::vector<Value>& n, Ark::VM* vm [[maybe_unused]])
+    Value sleep(ArgsView n, Ark::VM* vm [[maybe_unused]])
     {
         if (n.size() != 1)
             throw std::runtime_error(SYS_SLEEP_ARITY);
@@ -83,7 +83,7 @@ namespace Ark::internal::Builtins::System
      * =end
      * @author https://github.com/SuperFola
      */
-    Value exit_(std::vector<Value>& n, Ark::VM* vm)
+    Value exit_(ArgsView n, Ark::VM* vm)
     {
         if (n.size() != 1)
             throw std::runtime_error(SYS_EXIT_ARITY);
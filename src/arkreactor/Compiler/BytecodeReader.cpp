@@ -116,6 +116,7 @@ namespace Ark
 
         std::vector<std::string> symbols;
         std::vector<std::string> values;
+        std::vector<std::vector<uint16_t>> locals;
 
         // reading the different tables, one after another
 
@@ -258,6 +259,60 @@ namespace Ark
         if (segment == BytecodeSegment::Values)
             return;
 
+        if (b[i] == Instruction::FUNCTIONS_TABLE_START)
+        {
+            i++;
+            uint16_t size = readNumber(i);
+            i++;
+
+            bool showFunctions = (segment == BytecodeSegment::All || segment == BytecodeSegment::HeadersOnly);
+            if (showFunctions)
+                os << termcolor::green << "Functions table" << termcolor::reset << " (length: " << size << ")\n";
+
+            for (uint16_t j = 0; j < size; ++j)
+            {
+                uint16_t name = readNumber(i);
+                i++;
+                uint16_t arity = readNumber(i);
+                i++;
+                uint16_t max_stack = readNumber(i);
+                i++;
+                uint16_t count = readNumber(i);
+                i++;
+
+                if (showFunctions)
+                    os << static_cast<int>(j) << ") " << (name < symbols.size() ? symbols[name] : "(anonymous)")
+                       << ", arity: " << arity << ", max stack: " << max_stack << ", locals:";
+
+                locals.emplace_back();
+                for (uint16_t k = 0; k < count; ++k)
+                {
+                    locals.back().push_back(readNumber(i));
+                    i++;
+                    if (showFunctions)
+                        os << " " << symbols[locals.back().back()];
+                }
+                if (showFunctions)
+                    os << "\n";
+            }
+
+            if (showFunctions)
+                os << "\n";
+        }
+        else
+        {
+            os << termcolor::red << "Missing functions table entry point\n"
+               << termcolor::reset;
+            return;
+        }
+
+        // name of a local variable from its slot in the current page
+        auto local_name = [&locals, &symbols](uint16_t page, uint16_t slot) -> std::string {
+            if (page < locals.size() && slot < locals[page].size())
+                return symbols[locals[page][slot]];
+            return "(" + std::to_string(slot) + ")";
+        };
+
         uint16_t pp = 0;
 
         while (b[i] == Instruction::CODE_SEGMENT_START && (segment == BytecodeSegment::All || segment == BytecodeSegment::Code || segment == BytecodeSegment::HeadersOnly))
@@ -375,6 +430,13 @@ namespace Ark
                             os << "CALL " << termcolor::reset << "(" << value << ")\n";
                         i++;
                     }
+                    else if (inst == Instruction::TAIL_CALL)
+                    {
+                        uint16_t value = readNumber(i);
+                        if (displayLine)
+                            os << "TAIL_CALL " << termcolor::reset << "(" << value << ")\n";
+                        i++;
+                    }
                     else if (inst == Instruction::CAPTURE)
                     {
                         uint16_t index = readNumber(i);
@@ -471,6 +533,34 @@ namespace Ark
                             os << "POP_LIST_IN_PLACE " << termcolor::reset << "(" << value << ")\n";
                         i++;
                     }
+                    else if (inst == Instruction::LOAD_LOCAL)
+                    {
+                        uint16_t slot = readNumber(i);
+                        if (displayLine)
+                            os << "LOAD_LOCAL " << termcolor::green << local_name(pp, slot) << "\n";
+                        i++;
+                    }
+                    else if (inst == Instruction::STORE_LOCAL)
+                    {
+                        uint16_t slot = readNumber(i);
+                        if (displayLine)
+                            os << "STORE_LOCAL " << termcolor::green << local_name(pp, slot) << "\n";
+                        i++;
+                    }
+                    else if (inst == Instruction::SET_LOCAL)
+                    {
+                        uint16_t slot = readNumber(i);
+                        if (displayLine)
+                            os << "SET_LOCAL " << termcolor::green << local_name(pp, slot) << "\n";
+                        i++;
+                    }
+                    else if (inst == Instruction::LET_LOCAL)
+                    {
+                        uint16_t slot = readNumber(i);
+                        if (displayLine)
+                            os << "LET_LOCAL " << termcolor::green << local_name(pp, slot) << "\n";
+                        i++;
+                    }
                     else if (inst == Instruction::ADD)
                     {
                         if (displayLine)
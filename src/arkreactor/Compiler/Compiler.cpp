@@ -3,6 +3,7 @@
 #include <fstream>
 #include <chrono>
 #include <limits>
+#include <algorithm>
 #include <picosha2.h>
 
 #include <Ark/Literals.hpp>
@@ -17,7 +18,7 @@ namespace Ark
 
     Compiler::Compiler(unsigned debug, const std::vector<std::string>& libenv, uint16_t options) :
         m_parser(debug, options, libenv), m_optimizer(options),
-        m_options(options), m_debug(debug)
+        m_options(options), m_frame_page(0), m_function_name(internal::FunctionInfo::NoName), m_debug(debug)
     {}
 
     void Compiler::feed(const std::string& code, const std::string& filename)
@@ -34,6 +35,7 @@ namespace Ark
         pushHeadersPhase1();
 
         m_code_pages.emplace_back();  // create empty page
+        m_functions.emplace_back();  // the global scope doesn't have local variables
 
         // gather symbols, values, and start to create code segments
         _compile(m_optimizer.ast(), 0);
@@ -126,6 +128,8 @@ namespace Ark
                 + elements
             - values table header
                 + elements
+            - functions table header
+                + name, arity, max stack size, number of local variables and their symbol ids, for each page
          */
 
         m_bytecode.push_back(Instruction::SYM_TABLE_START);
@@ -173,6 +177,25 @@ namespace Ark
 
             m_bytecode.push_back(0_u8);
         }
+
+        // functions table
+        m_bytecode.push_back(Instruction::FUNCTIONS_TABLE_START);
+        // push number of pages
+        pushNumber(static_cast<uint16_t>(m_functions.size()));
+        for (std::size_t i = 0, end = m_functions.size(); i < end; ++i)
+        {
+            internal::FunctionInfo& info = m_functions[i];
+            // the arguments and the return address are already on the stack when entering a function
+            info.max_stack = computeMaxStack(m_code_pages[i], i == 0 ? 0 : info.arity + 2);
+
+            pushNumber(info.name);
+            pushNumber(info.arity);
+            pushNumber(info.max_stack);
+            // push the symbol id of each slot
+            pushNumber(static_cast<uint16_t>(info.locals.size()));
+            for (uint16_t id : info.locals)
+                pushNumber(id);
+        }
     }
 
     std::size_t Compiler::countArkObjects(const std::vector<Node>& lst) noexcept
@@ -229,7 +252,7 @@ namespace Ark
         throw CompilationError(makeNodeBasedErrorCtx(message, node));
     }
 
-    void Compiler::_compile(const Node& x, int p)
+    void Compiler::_compile(const Node& x, int p, bool is_terminal)
     {
         // register symbols
         if (x.nodeType() == NodeType::Symbol)
@@ -269,7 +292,7 @@ namespace Ark
             switch (n)
             {
                 case Keyword::If:
-                    compileIf(x, p);
+                    compileIf(x, p, is_terminal);
                     break;
 
                 case Keyword::Set:
@@ -288,8 +311,9 @@ namespace Ark
 
                 case Keyword::Begin:
                 {
+                    // only the last expression of a block can be in tail position
                     for (std::size_t i = 1, size = x.constList().size(); i < size; ++i)
-                        _compile(x.constList()[i], p);
+                        _compile(x.constList()[i], p, is_terminal && i + 1 == size);
                     break;
                 }
 
@@ -314,7 +338,7 @@ namespace Ark
         {
             // if we are here, we should have a function name
             // push arguments first, then function name, then call it
-            handleCalls(x, p);
+            handleCalls(x, p, is_terminal);
         }
     }
 
@@ -333,8 +357,16 @@ namespace Ark
         {
             uint16_t i = addSymbol(x);
 
-            page(p).emplace_back(Instruction::LOAD_SYMBOL);
-            pushNumber(i, page_ptr(p));
+            if (auto slot = localSlot(i))
+            {
+                page(p).emplace_back(Instruction::LOAD_LOCAL);
+                pushNumber(slot.value(), page_ptr(p));
+            }
+            else
+            {
+                page(p).emplace_back(Instruction::LOAD_SYMBOL);
+                pushNumber(i, page_ptr(p));
+            }
         }
     }
 
@@ -370,7 +402,7 @@ namespace Ark
         pushSpecificInstArgc(inst, argc, p);
     }
 
-    void Compiler::compileIf(const Node& x, int p)
+    void Compiler::compileIf(const Node& x, int p, bool is_terminal)
     {
         // compile condition
         _compile(x.constList()[1], p);
@@ -381,7 +413,7 @@ namespace Ark
         pushNumber(0_u16, page_ptr(p));
         // else code
         if (x.constList().size() == 4)  // we have an else clause
-            _compile(x.constList()[3], p);
+            _compile(x.constList()[3], p, is_terminal);
         // when else is finished, jump to end
         page(p).emplace_back(Instruction::JUMP);
         std::size_t jump_to_end_pos = page(p).size();
@@ -390,7 +422,7 @@ namespace Ark
         page(p)[jump_to_if_pos] = (static_cast<uint16_t>(page(p).size()) & 0xff00) >> 8;
         page(p)[jump_to_if_pos + 1] = static_cast<uint16_t>(page(p).size()) & 0x00ff;
         // if code
-        _compile(x.constList()[2], p);
+        _compile(x.constList()[2], p, is_terminal);
         // set jump to end pos
         page(p)[jump_to_end_pos] = (static_cast<uint16_t>(page(p).size()) & 0xff00) >> 8;
         page(p)[jump_to_end_pos + 1] = static_cast<uint16_t>(page(p).size()) & 0x00ff;
@@ -422,21 +454,42 @@ namespace Ark
         page(p).emplace_back(Instruction::LOAD_CONST);
         uint16_t id = addValue(page_id, x);  // save page_id into the constants table as PageAddr
         pushNumber(id, page_ptr(p));
+
+        m_functions.emplace_back();
+        m_functions[page_id].name = m_function_name;
+        m_function_name = internal::FunctionInfo::NoName;
+
+        // the arguments take the first slots, then come the variables created in the body
+        for (auto it = x.constList()[1].constList().begin(), it_end = x.constList()[1].constList().end(); it != it_end; ++it)
+        {
+            if (it->nodeType() == NodeType::Symbol)
+            {
+                addLocal(*it, m_functions[page_id].locals);
+                m_functions[page_id].arity++;
+            }
+        }
+        collectLocals(x.constList()[2], m_functions[page_id].locals);
+
+        std::size_t previous_frame = m_frame_page;
+        m_frame_page = page_id;
+
         // pushing arguments from the stack into variables in the new scope
         for (auto it = x.constList()[1].constList().begin(), it_end = x.constList()[1].constList().end(); it != it_end; ++it)
         {
             if (it->nodeType() == NodeType::Symbol)
             {
-                page(page_id).emplace_back(Instruction::MUT);
+                page(page_id).emplace_back(Instruction::SET_LOCAL);
                 uint16_t var_id = addSymbol(*it);
                 addDefinedSymbol(it->string());
-                pushNumber(var_id, page_ptr(page_id));
+                pushNumber(localSlot(var_id).value(), page_ptr(page_id));
             }
         }
-        // push body of the function
-        _compile(x.constList()[2], page_id);
+        // push body of the function, its last expression is in tail position
+        _compile(x.constList()[2], page_id, /* is_terminal */ true);
         // return last value on the stack
         page(page_id).emplace_back(Instruction::RET);
+
+        m_frame_page = previous_frame;
     }
 
     void Compiler::compileLetMut(Keyword n, const Node& x, int p)
@@ -446,10 +499,19 @@ namespace Ark
         addDefinedSymbol(name);
 
         // put value before symbol id
+        nameFunction(x, i);
         putValue(x, p);
 
-        page(p).emplace_back(n == Keyword::Let ? Instruction::LET : Instruction::MUT);
-        pushNumber(i, page_ptr(p));
+        if (auto slot = localSlot(i))
+        {
+            page(p).emplace_back(n == Keyword::Let ? Instruction::LET_LOCAL : Instruction::SET_LOCAL);
+            pushNumber(slot.value(), page_ptr(p));
+        }
+        else
+        {
+            page(p).emplace_back(n == Keyword::Let ? Instruction::LET : Instruction::MUT);
+            pushNumber(i, page_ptr(p));
+        }
     }
 
     void Compiler::compileWhile(const Node& x, int p)
@@ -479,10 +541,19 @@ namespace Ark
         uint16_t i = addSymbol(x.constList()[1]);
 
         // put value before symbol id
+        nameFunction(x, i);
         putValue(x, p);
 
-        page(p).emplace_back(Instruction::STORE);
-        pushNumber(i, page_ptr(p));
+        if (auto slot = localSlot(i))
+        {
+            page(p).emplace_back(Instruction::STORE_LOCAL);
+            pushNumber(slot.value(), page_ptr(p));
+        }
+        else
+        {
+            page(p).emplace_back(Instruction::STORE);
+            pushNumber(i, page_ptr(p));
+        }
     }
 
     void Compiler::compileQuote(const Node& x, int p)
@@ -490,8 +561,15 @@ namespace Ark
         // create new page for quoted code
         m_code_pages.emplace_back();
         std::size_t page_id = m_code_pages.size() - 1;
+        // quoted code is called like a function, and gets its own frame
+        m_functions.emplace_back();
+        collectLocals(x.constList()[1], m_functions[page_id].locals);
+
+        std::size_t previous_frame = m_frame_page;
+        m_frame_page = page_id;
         _compile(x.constList()[1], page_id);
         page(page_id).emplace_back(Instruction::RET);  // return to the last frame
+        m_frame_page = previous_frame;
 
         // call it
         uint16_t id = addValue(page_id, x);  // save page_id into the constants table as PageAddr
@@ -519,7 +597,7 @@ namespace Ark
         pushNumber(i, page_ptr(p));
     }
 
-    void Compiler::handleCalls(const Node& x, int p)
+    void Compiler::handleCalls(const Node& x, int p, bool is_terminal)
     {
         m_temp_pages.emplace_back();
         int proc_page = -static_cast<int>(m_temp_pages.size());
@@ -552,8 +630,8 @@ namespace Ark
                 page(p).push_back(inst);
             m_temp_pages.pop_back();
 
-            // call the procedure
-            page(p).push_back(Instruction::CALL);
+            // call the procedure, a call in tail position can reuse the frame of the current function
+            page(p).push_back(is_terminal ? Instruction::TAIL_CALL : Instruction::CALL);
             // number of arguments
             std::size_t args_count = 0;
             for (auto it = x.constList().begin() + 1, it_end = x.constList().end(); it != it_end; ++it)
@@ -617,6 +695,154 @@ namespace Ark
         }
     }
 
+    void Compiler::collectLocals(const Node& x, std::vector<uint16_t>& layout)
+    {
+        if (x.nodeType() != NodeType::List || x.constList().empty())
+            return;
+
+        if (const Node& c0 = x.constList()[0]; c0.nodeType() == NodeType::Keyword)
+        {
+            // functions and quoted code have their own frame
+            if (c0.keyword() == Keyword::Fun || c0.keyword() == Keyword::Quote)
+                return;
+            else if ((c0.keyword() == Keyword::Let || c0.keyword() == Keyword::Mut) && x.constList().size() > 1)
+                addLocal(x.constList()[1], layout);
+        }
+
+        for (const Node& node : x.constList())
+            collectLocals(node, layout);
+    }
+
+    void Compiler::addLocal(const Node& sym, std::vector<uint16_t>& layout)
+    {
+        uint16_t id = addSymbol(sym);
+        if (std::find(layout.begin(), layout.end(), id) == layout.end())
+            layout.push_back(id);
+    }
+
+    std::optional<uint16_t> Compiler::localSlot(uint16_t id) noexcept
+    {
+        const std::vector<uint16_t>& layout = m_functions[m_frame_page].locals;
+
+        auto it = std::find(layout.begin(), layout.end(), id);
+        if (it != layout.end())
+            return static_cast<uint16_t>(std::distance(layout.begin(), it));
+        return {};
+    }
+
+    void Compiler::nameFunction(const Node& x, uint16_t id) noexcept
+    {
+        // only (let|mut|set name (fun ...)) gives a name to a function
+        if (x.constList().size() == 3 && x.constList()[2].nodeType() == NodeType::List &&
+            !x.constList()[2].constList().empty() && x.constList()[2].constList()[0].nodeType() == NodeType::Keyword &&
+            x.constList()[2].constList()[0].keyword() == Keyword::Fun)
+            m_function_name = id;
+    }
+
+    uint16_t Compiler::computeMaxStack(const std::vector<uint8_t>& page, uint16_t initial) noexcept
+    {
+        // stack depth when reaching each address, -1 if not visited yet
+        std::vector<int> depth(page.size() + 1, -1);
+        std::vector<std::size_t> to_visit = { 0 };
+        depth[0] = initial;
+        int max_depth = initial;
+
+        while (!to_visit.empty())
+        {
+            std::size_t addr = to_visit.back();
+            to_visit.pop_back();
+            if (addr >= page.size())
+                continue;
+
+            uint8_t inst = page[addr];
+            int arg = 0;
+            std::size_t next = addr + 1;
+            if (hasArgument(inst) && addr + 2 < page.size())
+            {
+                arg = (static_cast<int>(page[addr + 1]) << 8) + static_cast<int>(page[addr + 2]);
+                next = addr + 3;
+            }
+
+            int d = depth[addr];
+            switch (inst)
+            {
+                case Instruction::LOAD_SYMBOL:
+                case Instruction::LOAD_CONST:
+                case Instruction::BUILTIN:
+                case Instruction::LOAD_LOCAL:
+                    d += 1;
+                    break;
+
+                case Instruction::POP_JUMP_IF_TRUE:
+                case Instruction::POP_JUMP_IF_FALSE:
+                case Instruction::STORE:
+                case Instruction::LET:
+                case Instruction::MUT:
+                case Instruction::STORE_LOCAL:
+                case Instruction::SET_LOCAL:
+                case Instruction::LET_LOCAL:
+                case Instruction::POP_LIST:
+                    d -= 1;
+                    break;
+
+                case Instruction::POP_LIST_IN_PLACE:
+                case Instruction::ASSERT:
+                    d -= 2;
+                    break;
+
+                case Instruction::CALL:
+                case Instruction::TAIL_CALL:
+                    // pop the function and its arguments, push the result
+                    d -= arg;
+                    break;
+
+                case Instruction::LIST:
+                    d += 1 - arg;
+                    break;
+
+                case Instruction::APPEND:
+                case Instruction::CONCAT:
+                case Instruction::APPEND_IN_PLACE:
+                case Instruction::CONCAT_IN_PLACE:
+                    d -= arg;
+                    break;
+
+                default:
+                    // binary operators pop 2 values and push one, the others don't change the stack size
+                    if (inst >= Instruction::FIRST_OPERATOR && inst <= Instruction::LAST_OPERATOR &&
+                        inst != Instruction::LEN && inst != Instruction::EMPTY && inst != Instruction::TAIL &&
+                        inst != Instruction::HEAD && inst != Instruction::ISNIL && inst != Instruction::TO_NUM &&
+                        inst != Instruction::TO_STR && inst != Instruction::TYPE && inst != Instruction::NOT)
+                        d -= 1;
+                    break;
+            }
+
+            d = std::max(d, 0);
+            max_depth = std::max(max_depth, d);
+
+            auto visit = [&depth, &to_visit](std::size_t target, int target_depth) {
+                // the first path reaching an address decides its depth
+                if (target < depth.size() && depth[target] == -1)
+                {
+                    depth[target] = target_depth;
+                    to_visit.push_back(target);
+                }
+            };
+
+            if (inst == Instruction::JUMP)
+                visit(static_cast<std::size_t>(arg), d);
+            else if (inst == Instruction::POP_JUMP_IF_TRUE || inst == Instruction::POP_JUMP_IF_FALSE)
+            {
+                visit(static_cast<std::size_t>(arg), d);
+                visit(next, d);
+            }
+            else if (inst != Instruction::RET && inst != Instruction::HALT)
+                visit(next, d);
+        }
+
+        return static_cast<uint16_t>(std::min(max_depth, static_cast<int>(std::numeric_limits<uint16_t>::max())));
+    }
+
     void Compiler::putValue(const Node& x, int p)
     {
         // starting at index = 2 because x is a (let|mut|set variable ...) node
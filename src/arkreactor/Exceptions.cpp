@@ -1,4 +1,3 @@
-#include <termcolor/termcolor.hpp>
 #include <Ark/Exceptions.hpp>
 #include <Ark/Utils.hpp>
 
@@ -7,7 +6,7 @@ namespace Ark
     BetterTypeError::BetterTypeError(std::string_view func_name, std::size_t expected_argc, const std::vector<Value>& args) :
         Error(), m_funcname(func_name), m_arg_index(0), m_expected_argc(expected_argc), m_args(args)
     {
-        std::cout << func_name << ": needs " << expected_argc << " argument(s)," << (args.size() == expected_argc ? "" : " but") << " got " << args.size() << std::endl;
+        m_message = std::string(func_name) + ": needs " + std::to_string(expected_argc) + " argument(s)," + (args.size() == expected_argc ? "" : " but") + " got " + std::to_string(args.size());
     }
 
     BetterTypeError& BetterTypeError::withArg(std::string_view arg_name, const std::vector<ValueType>& arg_types)
@@ -27,20 +26,11 @@ namespace Ark
         if (m_arg_index < m_args.size())
         {
             std::size_t provided_type = static_cast<std::size_t>(m_args[m_arg_index].valueType());
-
-            if (std::find(arg_types.begin(), arg_types.end(), m_args[m_arg_index].valueType()) == arg_types.end())
-            {
-                std::cout << termcolor::yellow;
-            }
-
-            std::cout << "  -> " << arg_name << " (" << arg_str << ") was of type " << types_to_str[provided_type] << termcolor::reset << std::endl;
+            m_message += "\n  -> " + std::string(arg_name) + " (" + arg_str + ") was of type " + types_to_str[provided_type];
         }
         // argument was not provided
         else
-        {
-            std::cout << termcolor::yellow;
-            std::cout << "  -> " << arg_name << " (" << arg_str << ") was not provided" << termcolor::reset << std::endl;
-        }
+            m_message += "\n  -> " + std::string(arg_name) + " (" + arg_str + ") was not provided";
 
         m_arg_index++;
         return *this;
@@ -0,0 +1,231 @@
+#include <Ark/VM/GarbageCollector.hpp>
+
+#include <unordered_map>
+#include <algorithm>
+#include <iterator>
+
+namespace Ark::internal
+{
+    /**
+     * @brief Object of the graph of references examined by a collection
+     *
+     */
+    struct GarbageCollector::Node
+    {
+        enum class Kind
+        {
+            Scope,
+            Closure,
+            List
+        };
+
+        Kind kind;
+        void* object;
+        long refs;  ///< references to the object, minus the ones coming from the graph
+        bool reachable = false;
+        std::weak_ptr<Scope> scope = {};  ///< only for the scopes, to be able to free them
+    };
+
+    /**
+     * @brief Graph of the objects reachable from the tracked scopes
+     *
+     */
+    class GarbageCollector::Graph
+    {
+    public:
+        /**
+         * @brief Add a scope to the graph if it isn't already in it
+         *
+         * @param scope
+         * @return std::size_t index of its node
+         */
+        std::size_t add(const Scope_t& scope)
+        {
+            std::size_t i = add(Node::Kind::Scope, scope.get(), scope.use_count());
+            if (m_nodes[i].scope.expired())
+                m_nodes[i].scope = scope;
+            return i;
+        }
+
+        /**
+         * @brief Call a function on the index of the node of each object directly referenced by
+         *        a given node, adding them to the graph
+         *
+         * @tparam F
+         * @param i index of the node
+         * @param visit
+         */
+        template <typename F>
+        void forEachReference(std::size_t i, F&& visit)
+        {
+            switch (m_nodes[i].kind)
+            {
+                case Node::Kind::Scope:
+                    for (const Scope::Binding& binding : bindings(*static_cast<Scope*>(m_nodes[i].object)))
+                        visitValue(binding.value, visit);
+                    break;
+
+                case Node::Kind::Closure:
+                    if (const Scope_t& scope = static_cast<ValueBox<Closure>*>(m_nodes[i].object)->data.scope(); scope)
+                        visit(add(scope));
+                    break;
+
+                case Node::Kind::List:
+                {
+                    // the elements of a persistent list may be shared with other lists, we can't know if they are
+                    // referenced from outside of the graph, thus they are left alive
+                    const ListStorage& storage = static_cast<ValueBox<ListStorage>*>(m_nodes[i].object)->data;
+                    if (!storage.persistent())
+                    {
+                        for (const Value& value : storage)
+                            visitValue(value, visit);
+                    }
+                    break;
+                }
+            }
+        }
+
+        inline std::vector<Node>& nodes() noexcept
+        {
+            return m_nodes;
+        }
+
+    private:
+        std::vector<Node> m_nodes;
+        std::unordered_map<void*, std::size_t> m_index;
+
+        std::size_t add(Node::Kind kind, void* object, long refs)
+        {
+            auto [it, inserted] = m_index.try_emplace(object, m_nodes.size());
+            if (inserted)
+                m_nodes.push_back(Node { kind, object, refs });
+            return it->second;
+        }
+
+        template <typename F>
+        void visitValue(const Value& value, F&& visit)
+        {
+            if (value.valueType() == ValueType::Closure)
+            {
+                auto cell = box<Closure>(value);
+                visit(add(Node::Kind::Closure, cell, cell->refcount.load(std::memory_order_relaxed)));
+            }
+            else if (value.valueType() == ValueType::List)
+            {
+                auto cell = box<ListStorage>(value);
+                visit(add(Node::Kind::List, cell, cell->refcount.load(std::memory_order_relaxed)));
+            }
+        }
+    };
+
+    GarbageCollector::GarbageCollector() noexcept :
+        m_created(0), m_threshold(ArkGCThreshold)
+    {
+        m_stats.threshold = m_threshold;
+    }
+
+    std::size_t GarbageCollector::collect(const Value* stack, std::size_t size)
+    {
+        Graph graph;
+        for (const std::weak_ptr<Scope>& weak : m_tracked)
+        {
+            if (Scope_t scope = weak.lock(); scope)
+                graph.nodes()[graph.add(scope)].refs -= 1;  // the reference we just created
+        }
+        m_tracked.clear();
+
+        // subtract the references coming from the graph, the new nodes being appended are examined as well
+        for (std::size_t i = 0; i < graph.nodes().size(); ++i)
+            graph.forEachReference(i, [&graph](std::size_t j) { --graph.nodes()[j].refs; });
+
+        // the references to variables found on the stack don't own their scope, but they must keep it alive
+        std::vector<const Value*> references;
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            if (stack[i].valueType() == ValueType::Reference)
+                references.push_back(stack[i].reference());
+        }
+        std::sort(references.begin(), references.end());
+
+        // the objects still referenced are reachable, and so is everything they reference
+        std::vector<std::size_t> to_visit;
+        for (std::size_t i = 0; i < graph.nodes().size(); ++i)
+        {
+            Node& node = graph.nodes()[i];
+            if (node.kind == Node::Kind::Scope && node.refs <= 0 && !references.empty())
+            {
+                const auto& data = bindings(*static_cast<Scope*>(node.object));
+                if (data.empty())
+                    continue;
+                auto it = std::lower_bound(references.begin(), references.end(), &data.data()->value);
+                if (it != references.end() && *it <= &data.back().value)
+                    node.refs = 1;
+            }
+
+            if (node.refs > 0)
+            {
+                node.reachable = true;
+                to_visit.push_back(i);
+            }
+        }
+        while (!to_visit.empty())
+        {
+            std::size_t i = to_visit.back();
+            to_visit.pop_back();
+
+            graph.forEachReference(i, [&graph, &to_visit](std::size_t j) {
+                if (!graph.nodes()[j].reachable)
+                {
+                    graph.nodes()[j].reachable = true;
+                    to_visit.push_back(j);
+                }
+            });
+        }
+
+        std::vector<Scope_t> garbage;
+        for (Node& node : graph.nodes())
+        {
+            if (node.kind != Node::Kind::Scope)
+                continue;
+
+            if (Scope_t scope = node.scope.lock(); scope)
+            {
+                if (node.reachable)
+                    m_tracked.emplace_back(scope);
+                else
+                    garbage.push_back(std::move(scope));
+            }
+        }
+
+        // destroying the variables of the garbage scopes breaks the cycles, the scopes are kept alive
+        // until all the variables are destroyed since the destructors can reach the other scopes
+        std::vector<Scope::Binding> variables;
+        for (Scope_t& scope : garbage)
+        {
+            std::vector<Scope::Binding>& data = bindings(*scope);
+            std::move(data.begin(), data.end(), std::back_inserter(variables));
+            data.clear();
+        }
+        variables.clear();
+
+        ++m_stats.collections;
+        m_stats.freed += garbage.size();
+        m_stats.tracked = m_tracked.size();
+        // the survivors will be examined again by the next collection, which must wait accordingly
+        m_stats.threshold = std::max(m_threshold, m_tracked.size());
+        m_created = 0;
+
+        return garbage.size();
+    }
+
+    void GarbageCollector::setThreshold(std::size_t threshold) noexcept
+    {
+        m_threshold = std::max<std::size_t>(threshold, 1);
+        m_stats.threshold = std::max(m_threshold, m_stats.tracked);
+    }
+
+    void GarbageCollector::setLimit(std::size_t limit) noexcept
+    {
+        m_stats.limit = limit;
+    }
+}
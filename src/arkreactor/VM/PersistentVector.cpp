@@ -0,0 +1,184 @@
+#include <Ark/VM/PersistentVector.hpp>
+
+#include <array>
+#include <algorithm>
+
+#include <Ark/VM/Value.hpp>
+
+namespace Ark::internal
+{
+    struct PersistentVector::Node
+    {};
+
+    struct PersistentVector::Branch : public PersistentVector::Node
+    {
+        std::array<std::shared_ptr<Node>, Width> children;
+    };
+
+    struct PersistentVector::Leaf : public PersistentVector::Node
+    {
+        std::array<Value, Width> values;
+    };
+
+    namespace
+    {
+        /**
+         * @brief Get a node to modify it, creating it if it doesn't exist and copying it if it is shared
+         *
+         * @tparam T Branch or Leaf
+         * @tparam N Node
+         * @param node
+         * @return T&
+         */
+        template <typename T, typename N>
+        T& own(std::shared_ptr<N>& node)
+        {
+            if (!node)
+                node = std::make_shared<T>();
+            else if (node.use_count() != 1)
+                node = std::make_shared<T>(static_cast<const T&>(*node));
+            return static_cast<T&>(*node);
+        }
+    }
+
+    PersistentVector::PersistentVector() noexcept :
+        m_shift(0), m_begin(0), m_end(0)
+    {}
+
+    PersistentVector::PersistentVector(const std::vector<Value>& values) :
+        PersistentVector()
+    {
+        for (const Value& value : values)
+            push_back(Value(value));
+    }
+
+    const PersistentVector::Leaf& PersistentVector::leafFor(std::size_t position) const noexcept
+    {
+        const Node* node = m_root.get();
+        for (unsigned shift = m_shift; shift > 0; shift -= Bits)
+            node = static_cast<const Branch*>(node)->children[(position >> shift) & Mask].get();
+        return *static_cast<const Leaf*>(node);
+    }
+
+    const Value& PersistentVector::operator[](std::size_t i) const noexcept
+    {
+        std::size_t position = m_begin + i;
+        return leafFor(position).values[position & Mask];
+    }
+
+    Value& PersistentVector::slot(std::size_t position)
+    {
+        // add levels on top of the root until the position fits in the tree
+        while ((position >> m_shift) >= Width)
+        {
+            auto root = std::make_shared<Branch>();
+            root->children[0] = std::move(m_root);
+            m_root = std::move(root);
+            m_shift += Bits;
+        }
+
+        std::shared_ptr<Node>* node = &m_root;
+        for (unsigned shift = m_shift; shift > 0; shift -= Bits)
+            node = &own<Branch>(*node).children[(position >> shift) & Mask];
+        return own<Leaf>(*node).values[position & Mask];
+    }
+
+    void PersistentVector::set(std::size_t i, Value&& value)
+    {
+        slot(m_begin + i) = std::move(value);
+    }
+
+    void PersistentVector::push_back(Value&& value)
+    {
+        slot(m_end) = std::move(value);
+        ++m_end;
+    }
+
+    void PersistentVector::pop_back()
+    {
+        --m_end;
+        // release the element, it may be the last reference to a closure or a list
+        slot(m_end) = Value();
+    }
+
+    void PersistentVector::pop_front()
+    {
+        ++m_begin;
+        // rebuild the tree without the removed elements once they use more than half of it,
+        // thus a loop removing the first element stays O(n)
+        if (m_begin >= Width && m_begin > size())
+            *this = PersistentVector(toVector());
+    }
+
+    std::vector<Value> PersistentVector::toVector() const
+    {
+        std::vector<Value> values;
+        values.reserve(size());
+
+        // copy the elements leaf by leaf
+        for (std::size_t position = m_begin; position < m_end;)
+        {
+            const Leaf& leaf = leafFor(position);
+            std::size_t count = std::min(Width - (position & Mask), m_end - position);
+            values.insert(values.end(), leaf.values.begin() + (position & Mask), leaf.values.begin() + (position & Mask) + count);
+            position += count;
+        }
+
+        return values;
+    }
+
+    // --------------------------
+
+    ListStorage::ListStorage(std::vector<Value>&& values) noexcept :
+        m_vector(std::move(values))
+    {}
+
+    ListStorage::ListStorage(PersistentVector&& values) noexcept :
+        m_tree(std::move(values)), m_persistent(true)
+    {}
+
+    ListStorage::ListStorage(const ListStorage& other) :
+        m_tree(other.m_tree), m_persistent(other.m_persistent)
+    {
+        // the copy of the elements of a persistent list isn't needed to copy it
+        if (!m_persistent)
+            m_vector = other.m_vector;
+    }
+
+    std::vector<Value> ListStorage::toVector() const
+    {
+        if (m_persistent)
+            return m_tree.toVector();
+        return m_vector;
+    }
+
+    PersistentVector ListStorage::persistentCopy() const
+    {
+        if (m_persistent)
+            return m_tree;
+        return PersistentVector(m_vector);
+    }
+
+    std::vector<Value>& ListStorage::mutableVector()
+    {
+        if (m_persistent)
+        {
+            m_vector = m_tree.toVector();
+            m_tree = PersistentVector();
+            m_persistent = false;
+        }
+        return m_vector;
+    }
+
+    PersistentVector& ListStorage::mutableTree()
+    {
+        if (!m_persistent)
+        {
+            m_tree = PersistentVector(m_vector);
+            m_persistent = true;
+            m_vector.clear();
+            m_vector.shrink_to_fit();
+        }
+        return m_tree;
+    }
+}
@@ -1,21 +1,38 @@
 #include <Ark/VM/Scope.hpp>
 
-#define push_pair(id, val) m_data.emplace_back(std::pair<uint16_t, Value>(id, val))
-#define insert_pair(place, id, val) m_data.insert(place, std::pair<uint16_t, Value>(id, val))
-
 namespace Ark::internal
 {
-    Scope::Scope() noexcept
+    Scope::Scope() noexcept :
+        m_indexed_by_id(false)
+    {}
+
+    Scope::Scope(std::size_t slots, bool indexed_by_id) noexcept :
+        m_data(slots, Binding { UnboundId, false, Value() }), m_indexed_by_id(indexed_by_id)
     {}
 
-    void Scope::push_back(uint16_t id, Value&& val) noexcept
+    void Scope::push_back(uint16_t id, Value&& val, bool is_const) noexcept
     {
-        push_pair(std::move(id), std::move(val));
+        if (m_indexed_by_id)
+        {
+            // symbols can be added after the creation of the scope (eg in the REPL)
+            if (id >= m_data.size())
+                m_data.resize(static_cast<std::size_t>(id) + 1, Binding { UnboundId, false, Value() });
+            m_data[id] = Binding { id, is_const, std::move(val) };
+        }
+        else
+            m_data.push_back(Binding { id, is_const, std::move(val) });
     }
 
-    void Scope::push_back(uint16_t id, const Value& val) noexcept
+    void Scope::push_back(uint16_t id, const Value& val, bool is_const) noexcept
     {
-        push_pair(id, val);
+        push_back(id, Value(val), is_const);
+    }
+
+    void Scope::reset(std::size_t slots) noexcept
+    {
+        m_data.clear();
+        m_data.resize(slots, Binding { UnboundId, false, Value() });
+        m_indexed_by_id = false;
     }
 
     bool Scope::has(uint16_t id) noexcept
@@ -25,10 +42,20 @@ namespace Ark::internal
 
     Value* Scope::operator[](uint16_t id) noexcept
     {
+        if (Binding* b = binding(id); b != nullptr)
+            return &b->value;
+        return nullptr;
+    }
+
+    Scope::Binding* Scope::binding(uint16_t id) noexcept
+    {
+        if (m_indexed_by_id)
+            return (id < m_data.size() && m_data[id].id == id) ? &m_data[id] : nullptr;
+
         for (std::size_t i = 0, end = m_data.size(); i < end; ++i)
         {
-            if (m_data[i].first == id)
-                return &m_data[i].second;
+            if (m_data[i].id == id)
+                return &m_data[i];
         }
         return nullptr;
     }
@@ -37,8 +64,8 @@ namespace Ark::internal
     {
         for (std::size_t i = 0, end = m_data.size(); i < end; ++i)
         {
-            if (m_data[i].second == val)
-                return m_data[i].first;
+            if (m_data[i].id != UnboundId && m_data[i].value == val)
+                return m_data[i].id;
         }
         return static_cast<uint16_t>(~0);
     }
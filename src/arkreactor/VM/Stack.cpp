@@ -0,0 +1,92 @@
+#include <Ark/VM/Stack.hpp>
+
+#include <new>
+#include <algorithm>
+
+#include <Ark/Platform.hpp>
+
+#ifdef ARK_OS_WINDOWS
+#    define WIN32_LEAN_AND_MEAN
+#    include <Windows.h>
+#else
+#    include <sys/mman.h>
+#endif
+
+namespace Ark::internal
+{
+    namespace
+    {
+        std::size_t toBytes(std::size_t values)
+        {
+            // whole chunks only, so that they match the memory pages
+            return (values + Stack::ChunkSize - 1) / Stack::ChunkSize * Stack::ChunkSize * sizeof(Value);
+        }
+    }
+
+    Stack::Stack(std::size_t capacity) :
+        m_data(nullptr), m_capacity(capacity), m_committed(0)
+    {
+#ifdef ARK_OS_WINDOWS
+        void* memory = VirtualAlloc(nullptr, toBytes(capacity), MEM_RESERVE, PAGE_NOACCESS);
+        if (memory == nullptr)
+            throw std::bad_alloc();
+#else
+        int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#    ifdef MAP_NORESERVE
+        flags |= MAP_NORESERVE;
+#    endif
+        // the system gives memory pages to a mapping only when they are touched
+        void* memory = mmap(nullptr, toBytes(capacity), PROT_READ | PROT_WRITE, flags, -1, 0);
+        if (memory == MAP_FAILED)
+            throw std::bad_alloc();
+#endif
+        m_data = static_cast<Value*>(memory);
+    }
+
+    Stack::~Stack()
+    {
+        for (std::size_t i = 0; i < m_committed; ++i)
+            m_data[i].~Value();
+
+#ifdef ARK_OS_WINDOWS
+        VirtualFree(m_data, 0, MEM_RELEASE);
+#else
+        munmap(m_data, toBytes(m_capacity));
+#endif
+    }
+
+    void Stack::commit(std::size_t size)
+    {
+        if (size <= m_committed)
+            return;
+
+        std::size_t new_committed = std::min(m_capacity, (size + ChunkSize - 1) / ChunkSize * ChunkSize);
+
+#ifdef ARK_OS_WINDOWS
+        if (VirtualAlloc(m_data + m_committed, (new_committed - m_committed) * sizeof(Value), MEM_COMMIT, PAGE_READWRITE) == nullptr)
+            throw std::bad_alloc();
+#endif
+
+        for (std::size_t i = m_committed; i < new_committed; ++i)
+            new (m_data + i) Value();
+        m_committed = new_committed;
+    }
+
+    void Stack::decommit(std::size_t size) noexcept
+    {
+        std::size_t new_committed = std::min(m_committed, (size + ChunkSize - 1) / ChunkSize * ChunkSize);
+        if (new_committed == m_committed)
+            return;
+
+        for (std::size_t i = new_committed; i < m_committed; ++i)
+            m_data[i].~Value();
+
+#ifdef ARK_OS_WINDOWS
+        VirtualFree(m_data + new_committed, (m_committed - new_committed) * sizeof(Value), MEM_DECOMMIT);
+#else
+        // the pages are given back to the system, and zeroed when touched again
+        madvise(m_data + new_committed, (m_committed - new_committed) * sizeof(Value), MADV_DONTNEED);
+#endif
+        m_committed = new_committed;
+    }
+}
@@ -2,6 +2,7 @@
 
 #include <Ark/Constants.hpp>
 #include <Ark/Utils.hpp>
+#include <Ark/Builtins/Builtins.hpp>
 
 #ifdef _MSC_VER
 #    pragma warning(push)
@@ -9,6 +10,8 @@
 #endif
 
 #include <stdlib.h>
+#include <algorithm>
+#include <limits>
 #include <picosha2.h>
 #include <termcolor/termcolor.hpp>
 
@@ -38,6 +41,15 @@ namespace Ark
         }
     }
 
+    State::~State()
+    {
+        // the constants are copies of the interned strings, which are the only owners of their cells once thawed
+        m_constants.clear();
+        for (auto& [key, str] : m_interned)
+            str.payloadAs<internal::ValueBox<String>>()->refcount.store(1, std::memory_order_relaxed);
+        m_interned.clear();
+    }
+
     bool State::feed(const std::string& bytecode_filename)
     {
         bool result = true;
@@ -177,6 +189,11 @@ namespace Ark
         m_binded[name] = Value(std::move(function));
     }
 
+    void State::loadFunction(const std::string& name, Value::LegacyProcType function) noexcept
+    {
+        m_binded[name] = Value(function);
+    }
+
     void State::setArgs(const std::vector<std::string>& args) noexcept
     {
         Value val(ValueType::List);
@@ -197,10 +214,29 @@ namespace Ark
         m_libenv = libenv;
     }
 
+    Value State::intern(const std::string& value)
+    {
+        const std::lock_guard<std::mutex> lock(m_interned_mutex);
+
+        if (auto it = m_interned.find(value); it != m_interned.end())
+            return it->second;
+
+        Value str(value);
+        auto cell = str.payloadAs<internal::ValueBox<String>>();
+        cell->hash = std::hash<std::string_view> {}(value) | 1;
+        cell->refcount.store(internal::FrozenRefcount, std::memory_order_relaxed);
+        // the key points to the content of the string, which is never modified while the table holds it
+        std::string_view key(str.string().c_str(), str.string().size());
+        return m_interned.emplace(key, std::move(str)).first->second;
+    }
+
     void State::configure()
     {
         using namespace internal;
 
+        // the virtual machines reset their caches when they see new code, even of the same size
+        ++m_code_generation;
+
         // configure tables and pages
         std::size_t i = 0;
 
@@ -224,13 +260,13 @@ namespace Ark
         uint16_t patch = readNumber(i);
         i++;
 
+        std::string str_version = std::to_string(major) + "." +
+            std::to_string(minor) + "." +
+            std::to_string(patch);
         if (major != ARK_VERSION_MAJOR)
-        {
-            std::string str_version = std::to_string(major) + "." +
-                std::to_string(minor) + "." +
-                std::to_string(patch);
             throwStateError("Compiler and VM versions don't match: " + str_version + " and " + ARK_VERSION_STR);
-        }
+        if ((major << 16) + (minor << 8) + patch < ARK_BYTECODE_MIN_VERSION)
+            throwStateError("Bytecode compiled by ArkScript " + str_version + " has no functions table, it must be recompiled");
 
         using timestamp_t = unsigned long long;
         timestamp_t timestamp [[maybe_unused]] = 0;
@@ -271,6 +307,12 @@ namespace Ark
 
                 m_symbols.push_back(symbol);
             }
+
+            // the strings of the table aren't moved anymore, they can be referenced by the index
+            m_symbol_ids.clear();
+            m_symbol_ids.reserve(m_symbols.size());
+            for (std::size_t j = 0, end = m_symbols.size(); j < end; ++j)
+                m_symbol_ids.emplace(m_symbols[j], static_cast<uint16_t>(j));
         }
         else
             throwStateError("Couldn't find symbols table");
@@ -303,7 +345,7 @@ namespace Ark
                         val.push_back(m_bytecode[i++]);
                     i++;
 
-                    m_constants.emplace_back(val);
+                    m_constants.push_back(intern(val));
                 }
                 else if (type == Instruction::FUNC_TYPE)
                 {
@@ -319,29 +361,193 @@ namespace Ark
         else
             throwStateError("Couldn't find constants table");
 
-        while (m_bytecode[i] == Instruction::CODE_SEGMENT_START)
+        if (m_bytecode[i] == Instruction::FUNCTIONS_TABLE_START)
         {
             i++;
             uint16_t size = readNumber(i);
+            m_functions.reserve(size);
             i++;
 
-            m_pages.emplace_back();
-            m_pages.back().reserve(size);
-
             for (uint16_t j = 0; j < size; ++j)
-                m_pages.back().push_back(m_bytecode[i++]);
+            {
+                FunctionInfo& info = m_functions.emplace_back();
+                info.name = readNumber(i);
+                i++;
+                info.arity = readNumber(i);
+                i++;
+                info.max_stack = readNumber(i);
+                i++;
+
+                uint16_t count = readNumber(i);
+                i++;
+                info.locals.reserve(count);
+                for (uint16_t k = 0; k < count; ++k)
+                {
+                    info.locals.push_back(readNumber(i));
+                    i++;
+                }
+            }
+        }
+        else
+            throwStateError("Couldn't find functions table");
+
+        while (m_bytecode[i] == Instruction::CODE_SEGMENT_START)
+        {
+            i++;
+            uint16_t size = readNumber(i);
+            i++;
+
+            decodePage(i, size);
+            i += size;
 
             if (i == m_bytecode.size())
                 break;
         }
+
+        if (m_functions.size() != m_pages_offsets.size())
+            throwStateError("the functions table doesn't match the code segments");
+
+        if (m_debug_level >= 2)
+        {
+            static const std::array<const char*, 4> names = { "LOAD_LOAD_OP", "LOAD_LOAD_OP_STORE", "LOAD_LOAD_CMP_JUMP", "CALL_BUILTIN" };
+            static_assert(names.size() == std::tuple_size_v<decltype(m_fusions)>);
+
+            std::cout << "Superinstructions:\n";
+            for (std::size_t j = 0; j < names.size(); ++j)
+                std::cout << "  " << names[j] << ": " << m_fusions[j] << "\n";
+        }
+    }
+
+    uint16_t State::nextCache(std::size_t& count) noexcept
+    {
+        // the instructions beyond the 65536th share the last cache, which is checked before being used
+        const std::size_t index = std::min<std::size_t>(count, std::numeric_limits<uint16_t>::max());
+        if (count == index)
+            ++count;
+        return static_cast<uint16_t>(index);
+    }
+
+    void State::decodePage(std::size_t begin, uint16_t size)
+    {
+        using namespace internal;
+
+        // first pass: map each byte address to an instruction index, needed to translate the jumps
+        std::vector<uint16_t> index_of(static_cast<std::size_t>(size) + 1, 0);
+        uint16_t count = 0;
+        for (std::size_t j = 0; j < size; ++count)
+        {
+            index_of[j] = count;
+            j += hasArgument(m_bytecode[begin + j]) ? 3 : 1;
+        }
+        index_of[size] = count;
+
+        const std::size_t page = m_pages_offsets.size();
+        m_pages_offsets.push_back(m_code.size());
+        m_code.reserve(m_code.size() + count);
+
+        for (std::size_t j = 0; j < size;)
+        {
+            DecodedInstruction inst { m_bytecode[begin + j], m_bytecode[begin + j], 0, 0 };
+            if (inst.opcode >= Instruction::FIRST_FUSED && inst.opcode <= Instruction::LAST_FUSED)
+                throwStateError("invalid code segment: unknown instruction at " + std::to_string(j));
+
+            if (inst.opcode >= Instruction::ADD && inst.opcode <= Instruction::EQ)
+                inst.extra = nextCache(m_operator_caches);
+            else if (inst.opcode == Instruction::GET_FIELD)
+                inst.extra = nextCache(m_field_caches);
+
+            if (hasArgument(inst.opcode))
+            {
+                if (j + 2 >= size)
+                    throwStateError("invalid code segment: missing argument for instruction at " + std::to_string(j));
+
+                inst.arg = (static_cast<uint16_t>(m_bytecode[begin + j + 1]) << 8) +
+                    static_cast<uint16_t>(m_bytecode[begin + j + 2]);
+                j += 3;
+
+                if (inst.opcode == Instruction::JUMP || inst.opcode == Instruction::POP_JUMP_IF_TRUE ||
+                    inst.opcode == Instruction::POP_JUMP_IF_FALSE)
+                {
+                    if (inst.arg > size)
+                        throwStateError("invalid code segment: jump out of the page at " + std::to_string(j - 3));
+                    inst.arg = index_of[inst.arg];
+                }
+                else if (inst.opcode == Instruction::LOAD_LOCAL || inst.opcode == Instruction::STORE_LOCAL ||
+                         inst.opcode == Instruction::SET_LOCAL || inst.opcode == Instruction::LET_LOCAL)
+                {
+                    if (page >= m_functions.size() || inst.arg >= m_functions[page].locals.size())
+                        throwStateError("invalid code segment: unknown local variable slot at " + std::to_string(j - 3));
+                    inst.extra = m_functions[page].locals[inst.arg];
+                }
+            }
+            else
+                ++j;
+
+            m_code.push_back(inst);
+        }
+
+        fuseInstructions(m_pages_offsets.back());
+    }
+
+    void State::fuseInstructions(std::size_t begin)
+    {
+        using namespace internal;
+
+        auto is_load = [this](const DecodedInstruction& inst) -> bool {
+            // loading a function may create a closure, keep it out of the superinstructions
+            return inst.opcode == Instruction::LOAD_SYMBOL || inst.opcode == Instruction::LOAD_LOCAL ||
+                (inst.opcode == Instruction::LOAD_CONST && inst.arg < m_constants.size() &&
+                 m_constants[inst.arg].valueType() != ValueType::PageAddr);
+        };
+        auto is_comparison = [](uint8_t inst) -> bool {
+            return inst == Instruction::GT || inst == Instruction::LT || inst == Instruction::LE ||
+                inst == Instruction::GE || inst == Instruction::NEQ || inst == Instruction::EQ;
+        };
+        auto is_binary_operator = [&is_comparison](uint8_t inst) -> bool {
+            return inst == Instruction::ADD || inst == Instruction::SUB || inst == Instruction::MUL ||
+                inst == Instruction::DIV || inst == Instruction::MOD || is_comparison(inst);
+        };
+        auto fuse = [this](DecodedInstruction& inst, Instruction fused) {
+            inst.opcode = fused;
+            ++m_fusions[fused - Instruction::FIRST_FUSED];
+        };
+
+        // every page ends with HALT, which is never part of a sequence
+        for (std::size_t i = begin, end = m_code.size(); i + 1 < end; ++i)
+        {
+            DecodedInstruction& inst = m_code[i];
+
+            if (i + 3 < end && is_load(inst) && is_load(m_code[i + 1]) && is_binary_operator(m_code[i + 2].opcode))
+            {
+                const uint8_t next = m_code[i + 3].opcode;
+
+                if (is_comparison(m_code[i + 2].opcode) && (next == Instruction::POP_JUMP_IF_TRUE || next == Instruction::POP_JUMP_IF_FALSE))
+                    fuse(inst, Instruction::LOAD_LOAD_CMP_JUMP);
+                else if (next == Instruction::STORE || next == Instruction::STORE_LOCAL)
+                    fuse(inst, Instruction::LOAD_LOAD_OP_STORE);
+                else
+                    fuse(inst, Instruction::LOAD_LOAD_OP);
+            }
+            else if (inst.opcode == Instruction::BUILTIN && inst.arg < Builtins::builtins.size() &&
+                     Builtins::builtins[inst.arg].second.valueType() == ValueType::CProc &&
+                     (m_code[i + 1].opcode == Instruction::CALL || m_code[i + 1].opcode == Instruction::TAIL_CALL))
+                fuse(inst, Instruction::CALL_BUILTIN);
+        }
     }
 
     void State::reset() noexcept
     {
+        m_symbol_ids.clear();
         m_symbols.clear();
         m_constants.clear();
-        m_pages.clear();
+        m_code.clear();
+        m_pages_offsets.clear();
+        m_functions.clear();
+        m_fusions.fill(0);
+        m_operator_caches = 0;
+        m_field_caches = 0;
         m_binded.clear();
+        // the interned strings are kept, since the virtual machines may still hold copies of them
     }
 }
 
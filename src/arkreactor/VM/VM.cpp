@@ -9,23 +9,107 @@ struct mapping
     Ark::Value (*value)(std::vector<Ark::Value>&, Ark::VM*);
 };
 
+// GCC and Clang support labels as values, which lets us jump directly from
+// one instruction handler to the next one instead of going through the switch
+#if (defined(__GNUC__) || defined(__clang__)) && !defined(ARK_NO_COMPUTED_GOTO)
+#    define ARK_USE_COMPUTED_GOTO
+#    pragma GCC diagnostic push
+#    pragma GCC diagnostic ignored "-Wpedantic"
+#endif
+
+#ifdef ARK_USE_COMPUTED_GOTO
+#    define TARGET(op) \
+        case Instruction::op: \
+        TARGET_##op:
+// a computed goto leaves the handler without calling the destructors of its local variables,
+// thus the handlers must not hold a value (or anything owning memory) when dispatching
+#    define DISPATCH_GOTO() goto* opcode_targets[ip->opcode]
+#else
+#    define TARGET(op) case Instruction::op:
+#    define DISPATCH_GOTO() continue
+#endif
+
+// move to the next instruction and execute it
+#define DISPATCH()      \
+    {                   \
+        ++ip;           \
+        DISPATCH_GOTO(); \
+    }
+// jump to an absolute address in the current page
+#define JUMP_TO(addr)      \
+    {                      \
+        ip = page + (addr); \
+        DISPATCH_GOTO();    \
+    }
+// consume the budget of the run at a checkpoint (backward jump, call, return), and suspend
+// the program when it's exhausted, ip being the instruction to resume from
+#define CHECK_BUDGET(cost)                                 \
+    if ((budget -= (cost)) < 0 && budgetExhausted(budget)) \
+    {                                                      \
+        m_yielded = true;                                  \
+        m_running = false;                                 \
+        continue;                                          \
+    }
+
 namespace Ark
 {
     using namespace internal;
 
-    VM::VM(State* state) noexcept :
+    VM::VM(State* state, std::size_t stack_size) noexcept :
         m_state(state), m_exit_code(0), m_ip(0), m_pp(0), m_sp(0), m_fc(0),
         m_running(false), m_last_sym_loaded(0),
-        m_until_frame_count(0), m_stack(nullptr), m_user_pointer(nullptr)
+        m_until_frame_count(0), m_yielded(false), m_suspended(false), m_can_suspend(false), m_budget(UnlimitedBudget),
+        m_stack_size(stack_size), m_stack(nullptr), m_user_pointer(nullptr), m_code_generation(0)
     {
         m_locals.reserve(4);
     }
 
+    VM::VM(const VM& other) :
+        m_state(other.m_state), m_exit_code(other.m_exit_code), m_ip(0), m_pp(0), m_sp(0), m_fc(other.m_fc),
+        m_running(false), m_last_sym_loaded(other.m_last_sym_loaded), m_until_frame_count(0),
+        m_yielded(false), m_suspended(false), m_can_suspend(false), m_budget(UnlimitedBudget),
+        m_stack_size(other.m_stack_size), m_stack(std::make_unique<Stack>(other.m_stack_size)),
+        m_scope_count_to_delete(other.m_scope_count_to_delete),
+        m_shared_lib_objects(other.m_shared_lib_objects),
+        m_user_pointer(other.m_user_pointer),
+        m_field_caches(other.m_field_caches),
+        m_operators(other.m_operators),
+        m_code_generation(other.m_code_generation)
+    {
+        m_gc.setThreshold(other.m_gc.threshold());
+        m_gc.setLimit(other.m_gc.stats().limit);
+
+        std::unordered_map<const Scope*, Scope_t> copies;
+        m_locals.reserve(other.m_locals.size());
+        for (const Scope_t& scope : other.m_locals)
+            m_locals.push_back(cloneScope(scope, copies));
+
+        // the copies of the closures environments can make cycles, like the originals
+        for (auto& [original, copy] : copies)
+        {
+            if (std::find(m_locals.begin(), m_locals.end(), copy) == m_locals.end())
+                m_gc.track(copy);
+        }
+    }
+
+    VM::~VM()
+    {
+        // once the VM doesn't hold them anymore, the values only referenced by cycles can be freed
+        m_locals.clear();
+        m_scope_pool.clear();
+        m_saved_scope.reset();
+        m_stack.reset();
+        m_gc.collect(nullptr, 0);
+    }
+
     void VM::init() noexcept
     {
         // initialize the stack
         if (m_stack == nullptr)
-            m_stack = std::make_unique<std::array<Value, ArkVMStackSize>>();
+            m_stack = std::make_unique<Stack>(m_stack_size);
+        else
+            // a previous run may have used a deep stack, keep only its first chunk
+            m_stack->decommit(Stack::ChunkSize);
 
         m_sp = 0;
         m_fc = 1;
@@ -36,9 +120,12 @@ namespace Ark
 
         m_saved_scope.reset();
         m_exit_code = 0;
+        m_yielded = false;
+        m_suspended = false;
 
         m_locals.clear();
-        createNewScope();
+        // the global scope has a slot for each symbol, to access the global variables by symbol id
+        m_locals.emplace_back(std::make_shared<Scope>(m_state->m_symbols.size(), /* indexed_by_id */ true));
 
         if (m_locals.size() == 0)
         {
@@ -48,30 +135,43 @@ namespace Ark
 
         // loading binded stuff
         // put them in the global frame if we can, aka the first one
-        for (auto name_val : m_state->m_binded)
+        for (const auto& [name, value] : m_state->m_binded)
         {
-            auto it = std::find(m_state->m_symbols.begin(), m_state->m_symbols.end(), name_val.first);
-            if (it != m_state->m_symbols.end())
-                (*m_locals[0]).push_back(static_cast<uint16_t>(std::distance(m_state->m_symbols.begin(), it)), name_val.second);
+            if (auto id = m_state->symbolId(name); id)
+                (*m_locals[0]).push_back(id.value(), value);
         }
     }
 
-    Value& VM::operator[](const std::string& name) noexcept
+    FunctionHandle VM::function(const std::string& name)
     {
-        const std::lock_guard<std::mutex> lock(m_mutex);
+        auto id = m_state->symbolId(name);
+        if (!id)
+            throwVMError("unbound variable: " + name);
+
+        Value* var = findNearestVariable(id.value());
+        if (var == nullptr)
+            throwVMError("Couldn't find variable " + name);
+        if (var->valueType() == ValueType::Reference)
+            var = var->reference();
+
+        if (var->valueType() != ValueType::PageAddr && var->valueType() != ValueType::Closure)
+            throwVMError("Can't call '" + name + "': it isn't a Function but a " + types_to_str[static_cast<int>(var->valueType())]);
+
+        return FunctionHandle(this, *var, id.value());
+    }
 
+    Value& VM::operator[](const std::string& name) noexcept
+    {
         // find id of object
-        auto it = std::find(m_state->m_symbols.begin(), m_state->m_symbols.end(), name);
-        if (it == m_state->m_symbols.end())
+        if (auto id = m_state->symbolId(name); id)
         {
-            m_no_value = Builtins::nil;
-            return m_no_value;
+            if (Value* var = findNearestVariable(id.value()); var != nullptr)
+            {
+                // the host may keep a copy after the State is destroyed
+                *var = var->thawed();
+                return *var;
+            }
         }
-
-        uint16_t id = static_cast<uint16_t>(std::distance(m_state->m_symbols.begin(), it));
-        Value* var = findNearestVariable(id);
-        if (var != nullptr)
-            return *var;
         m_no_value = Builtins::nil;
         return m_no_value;
     }
@@ -80,7 +180,7 @@ namespace Ark
     {
         namespace fs = std::filesystem;
 
-        const std::string file = m_state->m_constants[id].stringRef().toString();
+        const std::string file = std::string(m_state->m_constants[id].string().c_str());
 
         std::string path = file;
         // bytecode loaded from file
@@ -137,9 +237,8 @@ namespace Ark
         while (map[i].name != nullptr)
         {
             // put it in the global frame, aka the first one
-            auto it = std::find(m_state->m_symbols.begin(), m_state->m_symbols.end(), std::string(map[i].name));
-            if (it != m_state->m_symbols.end())
-                (*m_locals[0]).push_back(static_cast<uint16_t>(std::distance(m_state->m_symbols.begin(), it)), Value(map[i].value));
+            if (auto id = m_state->symbolId(map[i].name); id)
+                (*m_locals[0]).push_back(id.value(), Value(map[i].value));
 
             // free memory because we have used it and don't need it anymore
             // no need to free map[i].value since it's a pointer to a function in the DLL
@@ -151,6 +250,59 @@ namespace Ark
         delete[] map;
     }
 
+    Value VM::cloneValue(const Value& value, std::unordered_map<const Scope*, Scope_t>& copies)
+    {
+        if (value.valueType() == ValueType::Closure)
+        {
+            const Closure& closure = value.closure();
+            if (!closure.scope())
+                return value;
+            return Value(Closure(cloneScope(closure.scope(), copies), closure.pageAddr()));
+        }
+
+        // the lists are copied on write, but the closures they hold must get their own environment
+        if (value.valueType() == ValueType::List)
+        {
+            const ListStorage& storage = value.constList();
+            std::vector<Value> items;
+            for (std::size_t i = 0, end = storage.size(); i < end; ++i)
+            {
+                Value item = cloneValue(storage[i], copies);
+                if (items.empty() && item.m_bits == storage[i].m_bits)
+                    continue;
+
+                if (items.empty())
+                {
+                    items.reserve(end);
+                    for (std::size_t j = 0; j < i; ++j)
+                        items.push_back(storage[j]);
+                }
+                items.push_back(std::move(item));
+            }
+
+            if (!items.empty())
+                return Value(std::move(items));
+        }
+
+        return value;
+    }
+
+    Scope_t VM::cloneScope(const Scope_t& scope, std::unordered_map<const Scope*, Scope_t>& copies)
+    {
+        if (auto it = copies.find(scope.get()); it != copies.end())
+            return it->second;
+
+        Scope_t copy = std::make_shared<Scope>(*scope);
+        copies.emplace(scope.get(), copy);
+
+        for (Scope::Binding& binding : copy->m_data)
+        {
+            if (binding.value.valueType() == ValueType::Closure || binding.value.valueType() == ValueType::List)
+                binding.value = cloneValue(binding.value, copies);
+        }
+        return copy;
+    }
+
     void VM::exit(int code) noexcept
     {
         m_exit_code = code;
@@ -171,6 +323,32 @@ namespace Ark
         return m_user_pointer;
     }
 
+    // ------------------------------------------
+    //             garbage collection
+    // ------------------------------------------
+
+    std::size_t VM::collectGarbage()
+    {
+        if (m_stack == nullptr)
+            return m_gc.collect(nullptr, 0);
+        return m_gc.collect(m_stack->data(), m_sp);
+    }
+
+    const GCStats& VM::gcStats() const noexcept
+    {
+        return m_gc.stats();
+    }
+
+    void VM::setGCThreshold(std::size_t threshold) noexcept
+    {
+        m_gc.setThreshold(threshold);
+    }
+
+    void VM::setHeapLimit(std::size_t limit) noexcept
+    {
+        m_gc.setLimit(limit);
+    }
+
     // ------------------------------------------
     //                 execution
     // ------------------------------------------
@@ -187,44 +365,261 @@ namespace Ark
         return m_exit_code;
     }
 
+    ExecutionStatus VM::runFor(std::size_t instructions) noexcept
+    {
+        m_deadline.reset();
+        return runWithBudget(static_cast<std::int64_t>(std::min<std::size_t>(instructions, UnlimitedBudget)));
+    }
+
+    ExecutionStatus VM::runUntil(std::chrono::steady_clock::time_point deadline) noexcept
+    {
+        m_deadline = deadline;
+        return runWithBudget(static_cast<std::int64_t>(ArkVMTimeSlice));
+    }
+
+    ExecutionStatus VM::runWithBudget(std::int64_t budget) noexcept
+    {
+        // the program waits for the result of the function which suspended it
+        if (m_suspended)
+            return ExecutionStatus::Suspended;
+
+        if (m_yielded)
+            m_yielded = false;
+        else
+            init();
+
+        m_budget = budget;
+        m_can_suspend = true;
+        safeRun();
+        m_can_suspend = false;
+        m_budget = UnlimitedBudget;
+
+        if (m_suspended)
+        {
+            // resume from the instruction following the call
+            m_yielded = true;
+            return ExecutionStatus::Suspended;
+        }
+        if (m_yielded)
+            return ExecutionStatus::Yielded;
+
+        // reset VM after each run, like run()
+        m_ip = 0;
+        m_pp = 0;
+
+        return m_exit_code == 0 ? ExecutionStatus::Finished : ExecutionStatus::Failed;
+    }
+
+    bool VM::budgetExhausted(std::int64_t& budget) const noexcept
+    {
+        if (m_deadline && std::chrono::steady_clock::now() < m_deadline.value())
+        {
+            budget = static_cast<std::int64_t>(ArkVMTimeSlice);
+            return false;
+        }
+        return true;
+    }
+
+    Value VM::suspend()
+    {
+        if (!m_can_suspend || m_until_frame_count != 0)
+            throwVMError("can not suspend the program: it must be run by runFor, runUntil or resume, and the function called by the program itself");
+
+        m_suspended = true;
+        m_running = false;
+        return Builtins::nil;
+    }
+
+    bool VM::suspended() const noexcept
+    {
+        return m_suspended;
+    }
+
+    ExecutionStatus VM::resume(Value result, std::size_t instructions)
+    {
+        if (!m_suspended)
+            throwVMError("can not resume a program which isn't suspended");
+
+        // the placeholder returned by the function is on the top of the stack
+        (*m_stack)[m_sp - 1] = std::move(result);
+        m_suspended = false;
+
+        return runFor(instructions);
+    }
+
     int VM::safeRun(std::size_t untilFrameCount)
     {
+        try
+        {
+            execute(untilFrameCount);
+        }
+        catch (const std::exception& e)
+        {
+            std::printf("%s\n", e.what());
+            backtrace();
+            m_exit_code = 1;
+        }
+        catch (...)
+        {
+            std::printf("Unknown error\n");
+            backtrace();
+            m_exit_code = 1;
+        }
+
+        return m_exit_code;
+    }
+
+    void VM::execute(std::size_t untilFrameCount)
+    {
+        // a nested run (VM::call / VM::resolve from a C++ function) gives back the frame count of the enclosing one
+        std::size_t enclosing_frame_count = m_until_frame_count;
         m_until_frame_count = untilFrameCount;
+        // only the program can be suspended, the functions called from C++ by a nested run must complete
+        std::int64_t budget = untilFrameCount == 0 ? m_budget : UnlimitedBudget;
+        // the state may have loaded new code since the last run (eg in the REPL)
+        if (m_code_generation != m_state->m_code_generation)
+        {
+            m_code_generation = m_state->m_code_generation;
+            m_operators.assign(m_state->m_operator_caches, 0);
+            m_field_caches.assign(m_state->m_field_caches, FieldCache {});
+        }
+
+#ifdef ARK_USE_COMPUTED_GOTO
+        // one entry per possible byte, so that the dispatch never has to check bounds
+        static const void* opcode_targets[256] = {
+            &&TARGET_UNKNOWN,
+            &&TARGET_LOAD_SYMBOL,  // 0x1
+            &&TARGET_LOAD_CONST,  // 0x2
+            &&TARGET_POP_JUMP_IF_TRUE,  // 0x3
+            &&TARGET_STORE,  // 0x4
+            &&TARGET_LET,  // 0x5
+            &&TARGET_POP_JUMP_IF_FALSE,  // 0x6
+            &&TARGET_JUMP,  // 0x7
+            &&TARGET_RET,  // 0x8
+            &&TARGET_HALT,  // 0x9
+            &&TARGET_CALL,  // 0xa
+            &&TARGET_CAPTURE,  // 0xb
+            &&TARGET_BUILTIN,  // 0xc
+            &&TARGET_MUT,  // 0xd
+            &&TARGET_DEL,  // 0xe
+            &&TARGET_SAVE_ENV,  // 0xf
+            &&TARGET_GET_FIELD,  // 0x10
+            &&TARGET_PLUGIN,  // 0x11
+            &&TARGET_LIST,  // 0x12
+            &&TARGET_APPEND,  // 0x13
+            &&TARGET_CONCAT,  // 0x14
+            &&TARGET_APPEND_IN_PLACE,  // 0x15
+            &&TARGET_CONCAT_IN_PLACE,  // 0x16
+            &&TARGET_POP_LIST,  // 0x17
+            &&TARGET_POP_LIST_IN_PLACE,  // 0x18
+            &&TARGET_LOAD_LOCAL,  // 0x19
+            &&TARGET_STORE_LOCAL,  // 0x1a
+            &&TARGET_SET_LOCAL,  // 0x1b
+            &&TARGET_LET_LOCAL,  // 0x1c
+            &&TARGET_TAIL_CALL,  // 0x1d
+            &&TARGET_UNKNOWN, &&TARGET_UNKNOWN,
+            &&TARGET_ADD,  // 0x20
+            &&TARGET_SUB,  // 0x21
+            &&TARGET_MUL,  // 0x22
+            &&TARGET_DIV,  // 0x23
+            &&TARGET_GT,  // 0x24
+            &&TARGET_LT,  // 0x25
+            &&TARGET_LE,  // 0x26
+            &&TARGET_GE,  // 0x27
+            &&TARGET_NEQ,  // 0x28
+            &&TARGET_EQ,  // 0x29
+            &&TARGET_LEN,  // 0x2a
+            &&TARGET_EMPTY,  // 0x2b
+            &&TARGET_TAIL,  // 0x2c
+            &&TARGET_HEAD,  // 0x2d
+            &&TARGET_ISNIL,  // 0x2e
+            &&TARGET_ASSERT,  // 0x2f
+            &&TARGET_TO_NUM,  // 0x30
+            &&TARGET_TO_STR,  // 0x31
+            &&TARGET_AT,  // 0x32
+            &&TARGET_AND_,  // 0x33
+            &&TARGET_OR_,  // 0x34
+            &&TARGET_MOD,  // 0x35
+            &&TARGET_TYPE,  // 0x36
+            &&TARGET_HASFIELD,  // 0x37
+            &&TARGET_NOT,  // 0x38
+            &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN,
+            &&TARGET_LOAD_LOAD_OP,  // 0x40
+            &&TARGET_LOAD_LOAD_OP_STORE,  // 0x41
+            &&TARGET_LOAD_LOAD_CMP_JUMP,  // 0x42
+            &&TARGET_CALL_BUILTIN,  // 0x43
+            &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN,
+            &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN,
+            &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN,
+            &&TARGET_UNKNOWN, &&TARGET_UNKNOWN,
+            &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN,
+            &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN,
+            &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN,
+            &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN,
+            &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN,
+            &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN,
+            &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN,
+            &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN,
+            &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN,
+            &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN,
+            &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN,
+            &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN,
+            &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN,
+            &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN,
+            &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN,
+            &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN,
+            &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN,
+            &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN,
+            &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN,
+            &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN,
+            &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN, &&TARGET_UNKNOWN,
+        };
+#endif
+
+        // start of the current page and cached instruction pointer, m_ip is only
+        // synchronized with them when leaving the loop or calling into other methods
+        const DecodedInstruction* page = nullptr;
+        const DecodedInstruction* ip = nullptr;
+        // the state of the operators, never reallocated during a run
+        uint8_t* const operators = m_operators.data();
 
         try
         {
             m_running = true;
+            page = codePage(m_pp);
+            ip = page + m_ip;
+
             while (m_running && m_fc > m_until_frame_count)
             {
-                // get current instruction
-                uint8_t inst = m_state->m_pages[m_pp][m_ip];
+#ifdef ARK_USE_COMPUTED_GOTO
+                DISPATCH_GOTO();
+#endif
 
                 // and it's time to du-du-du-du-duel!
-                switch (inst)
+                switch (ip->opcode)
                 {
 #pragma region "Instructions"
 
-                    case Instruction::LOAD_SYMBOL:
+                    TARGET(LOAD_SYMBOL)
                     {
                         /*
                             Argument: symbol id (two bytes, big endian)
                             Job: Load a symbol from its id onto the stack
                         */
 
-                        ++m_ip;
-                        m_last_sym_loaded = readNumber();
+                        m_last_sym_loaded = ip->arg;
 
-                        if (Value* var = findNearestVariable(m_last_sym_loaded); var != nullptr)
+                        if (Scope::Binding* var = findNearestBinding(m_last_sym_loaded); var != nullptr)
                             // push internal reference, shouldn't break anything so far
-                            push(var);
+                            push(&var->value, var->is_const);
                         else
                             throwVMError("unbound variable: " + m_state->m_symbols[m_last_sym_loaded]);
 
                         COZ_PROGRESS_NAMED("ark vm load_symbol");
-                        break;
+                        DISPATCH();
                     }
 
-                    case Instruction::LOAD_CONST:
+                    TARGET(LOAD_CONST)
                     {
                         /*
                             Argument: constant id (two bytes, big endian)
@@ -232,25 +627,28 @@ namespace Ark
                                     and push a Closure with the page address + environment instead of the constant
                         */
 
-                        ++m_ip;
-                        uint16_t id = readNumber();
+                        uint16_t id = ip->arg;
 
                         if (m_saved_scope && m_state->m_constants[id].valueType() == ValueType::PageAddr)
                         {
                             push(Value(Closure(m_saved_scope.value(), m_state->m_constants[id].pageAddr())));
+                            m_gc.track(m_saved_scope.value());
                             m_saved_scope.reset();
+
+                            if (m_gc.shouldCollect())
+                                collectCycles();
                         }
                         else
                         {
-                            // push internal ref
-                            push(&(m_state->m_constants[id]));
+                            // push internal ref, as a constant so that the State isn't modified through it
+                            push(constant(id), /* is_const */ true);
                         }
 
                         COZ_PROGRESS_NAMED("ark vm load_const");
-                        break;
+                        DISPATCH();
                     }
 
-                    case Instruction::POP_JUMP_IF_TRUE:
+                    TARGET(POP_JUMP_IF_TRUE)
                     {
                         /*
                             Argument: absolute address to jump to (two bytes, big endian)
@@ -258,15 +656,14 @@ namespace Ark
                                     Remove the value from the stack no matter what it is
                         */
 
-                        ++m_ip;
-                        uint16_t id = readNumber();
+                        uint16_t id = ip->arg;
 
                         if (*popAndResolveAsPtr() == Builtins::trueSym)
-                            m_ip = static_cast<int16_t>(id) - 1;  // because we are doing a ++m_ip right after this
-                        break;
+                            JUMP_TO(id);
+                        DISPATCH();
                     }
 
-                    case Instruction::STORE:
+                    TARGET(STORE)
                     {
                         /*
                             Argument: symbol id (two bytes, big endian)
@@ -275,26 +672,13 @@ namespace Ark
                                     couldn't find a scope where the variable exists
                         */
 
-                        ++m_ip;
-                        uint16_t id = readNumber();
-
-                        if (Value* var = findNearestVariable(id); var != nullptr)
-                        {
-                            if (var->isConst())
-                                throwVMError("can not modify a constant: " + m_state->m_symbols[id]);
-
-                            *var = *popAndResolveAsPtr();
-                            var->setConst(false);
-                            break;
-                        }
+                        findStoreTarget(*ip)->value = popValue();
 
                         COZ_PROGRESS_NAMED("ark vm store");
-
-                        throwVMError("unbound variable " + m_state->m_symbols[id] + ", can not change its value");
-                        break;
+                        DISPATCH();
                     }
 
-                    case Instruction::LET:
+                    TARGET(LET)
                     {
                         /*
                             Argument: symbol id (two bytes, big endian)
@@ -302,22 +686,19 @@ namespace Ark
                                     following the given symbol id (cf symbols table)
                         */
 
-                        ++m_ip;
-                        uint16_t id = readNumber();
+                        uint16_t id = ip->arg;
 
                         // check if we are redefining a variable
                         if (auto val = (*m_locals.back())[id]; val != nullptr)
                             throwVMError("can not use 'let' to redefine the variable " + m_state->m_symbols[id]);
 
-                        Value val = *popAndResolveAsPtr();
-                        val.setConst(true);
-                        (*m_locals.back()).push_back(id, val);
+                        (*m_locals.back()).push_back(id, popValue(), /* is_const */ true);
 
                         COZ_PROGRESS_NAMED("ark vm let");
-                        break;
+                        DISPATCH();
                     }
 
-                    case Instruction::POP_JUMP_IF_FALSE:
+                    TARGET(POP_JUMP_IF_FALSE)
                     {
                         /*
                             Argument: absolute address to jump to (two bytes, big endian)
@@ -325,29 +706,30 @@ namespace Ark
                                     the value from the stack no matter what it is
                         */
 
-                        ++m_ip;
-                        uint16_t id = readNumber();
+                        uint16_t id = ip->arg;
 
                         if (*popAndResolveAsPtr() == Builtins::falseSym)
-                            m_ip = static_cast<int16_t>(id) - 1;  // because we are doing a ++m_ip right after this
-                        break;
+                            JUMP_TO(id);
+                        DISPATCH();
                     }
 
-                    case Instruction::JUMP:
+                    TARGET(JUMP)
                     {
                         /*
                             Argument: absolute address to jump to (two byte, big endian)
                             Job: Jump to the provided address
                         */
 
-                        ++m_ip;
-                        uint16_t id = readNumber();
-
-                        m_ip = static_cast<int16_t>(id) - 1;  // because we are doing a ++m_ip right after this
-                        break;
+                        uint16_t id = ip->arg;
+                        std::ptrdiff_t length = ip - page - id;
+                        ip = page + id;
+                        // a backward jump ends an iteration of a loop
+                        if (length > 0)
+                            CHECK_BUDGET(length)
+                        DISPATCH_GOTO();
                     }
 
-                    case Instruction::RET:
+                    TARGET(RET)
                     {
                         /*
                             Argument: none
@@ -355,7 +737,8 @@ namespace Ark
                                     the stack to the new stack ; should as well delete the current environment.
                         */
 
-                        Value ip_or_val = *popAndResolveAsPtr();
+                        std::ptrdiff_t position = ip - page;
+                        Value ip_or_val = popValue();
                         // no return value on the stack
                         if (ip_or_val.valueType() == ValueType::InstPtr)
                         {
@@ -370,32 +753,76 @@ namespace Ark
                         // value on the stack
                         else
                         {
-                            Value* ip;
+                            Value* ret_ip;
                             do
                             {
-                                ip = popAndResolveAsPtr();
-                            } while (ip->valueType() != ValueType::InstPtr);
+                                ret_ip = popAndResolveAsPtr();
+                            } while (ret_ip->valueType() != ValueType::InstPtr);
 
-                            m_ip = ip->pageAddr();
+                            m_ip = ret_ip->pageAddr();
                             m_pp = pop()->pageAddr();
 
                             returnFromFuncCall();
                             push(std::move(ip_or_val));
                         }
 
+                        // resume right after the CALL instruction we came from
+                        page = codePage(m_pp);
+                        ip = page + (m_ip + 1);
+
                         COZ_PROGRESS_NAMED("ark vm ret");
-                        break;
+                        CHECK_BUDGET(position)
+                        // the frame count changed, go back to the loop condition
+                        continue;
                     }
 
-                    case Instruction::HALT:
+                    TARGET(HALT)
                         m_running = false;
-                        break;
+                        ++ip;
+                        continue;
+
+                    TARGET(CALL)
+                    {
+                        // call() reads its argument through m_ip and may switch page,
+                        // and the page pointer must not be used by the error handler
+                        // while the VM is in-between two pages
+                        m_ip = static_cast<int>(ip - page);
+                        page = nullptr;
+                        call();
+                        page = codePage(m_pp);
+                        ip = page + (m_ip + 1);
+                        CHECK_BUDGET(1)
+                        // a CProc may have run a nested safeRun (VM::call / VM::resolve)
+                        continue;
+                    }
+
+                    TARGET(TAIL_CALL)
+                    {
+                        /*
+                            Argument: number of arguments when calling the function
+                            Job: Same as CALL, for a call in tail position. When a function calls itself, reuse its
+                                    frame and restart the page instead of creating a new frame
+                        */
+
+                        if (tailCall(ip->arg))
+                        {
+                            COZ_PROGRESS_NAMED("ark vm tail_call");
+                            std::ptrdiff_t length = ip - page;
+                            ip = page;
+                            CHECK_BUDGET(length)
+                            DISPATCH_GOTO();
+                        }
 
-                    case Instruction::CALL:
+                        m_ip = static_cast<int>(ip - page);
+                        page = nullptr;
                         call();
-                        break;
+                        page = codePage(m_pp);
+                        ip = page + (m_ip + 1);
+                        CHECK_BUDGET(1)
+                        continue;
+                    }
 
-                    case Instruction::CAPTURE:
+                    TARGET(CAPTURE)
                     {
                         /*
                             Argument: symbol id (two bytes, big endian)
@@ -404,37 +831,35 @@ namespace Ark
                                 they were created
                         */
 
-                        ++m_ip;
-                        uint16_t id = readNumber();
+                        uint16_t id = ip->arg;
 
                         if (!m_saved_scope)
                             m_saved_scope = std::make_shared<Scope>();
                         // if it's a captured variable, it can not be nullptr
-                        Value* ptr = (*m_locals.back())[id];
-                        ptr = ptr->valueType() == ValueType::Reference ? ptr->reference() : ptr;
-                        (*m_saved_scope.value()).push_back(id, *ptr);
+                        Scope::Binding* var = m_locals.back()->binding(id);
+                        Value* ptr = var->value.valueType() == ValueType::Reference ? var->value.reference() : &var->value;
+                        (*m_saved_scope.value()).push_back(id, *ptr, var->is_const);
 
                         COZ_PROGRESS_NAMED("ark vm capture");
-                        break;
+                        DISPATCH();
                     }
 
-                    case Instruction::BUILTIN:
+                    TARGET(BUILTIN)
                     {
                         /*
                             Argument: id of builtin (two bytes, big endian)
                             Job: Push the builtin function object on the stack
                         */
 
-                        ++m_ip;
-                        uint16_t id = readNumber();
+                        uint16_t id = ip->arg;
 
                         push(Builtins::builtins[id].second);
 
                         COZ_PROGRESS_NAMED("ark vm builtin");
-                        break;
+                        DISPATCH();
                     }
 
-                    case Instruction::MUT:
+                    TARGET(MUT)
                     {
                         /*
                             Argument: symbol id (two bytes, big endian)
@@ -442,32 +867,30 @@ namespace Ark
                                 named following the given symbol id (cf symbols table)
                         */
 
-                        ++m_ip;
-                        uint16_t id = readNumber();
-
-                        Value val = *popAndResolveAsPtr();
-                        val.setConst(false);
+                        uint16_t id = ip->arg;
 
                         // avoid adding the pair (id, _) multiple times, with different values
-                        Value* local = (*m_locals.back())[id];
+                        Scope::Binding* local = m_locals.back()->binding(id);
                         if (local == nullptr)
-                            (*m_locals.back()).push_back(id, val);
+                            (*m_locals.back()).push_back(id, popValue());
                         else
-                            *local = val;
+                        {
+                            local->value = popValue();
+                            local->is_const = false;
+                        }
 
                         COZ_PROGRESS_NAMED("ark vm mut");
-                        break;
+                        DISPATCH();
                     }
 
-                    case Instruction::DEL:
+                    TARGET(DEL)
                     {
                         /*
                             Argument: symbol id (two bytes, big endian)
                             Job: Remove a variable/constant named following the given symbol id (cf symbols table)
                         */
 
-                        ++m_ip;
-                        uint16_t id = readNumber();
+                        uint16_t id = ip->arg;
 
                         if (Value* var = findNearestVariable(id); var != nullptr)
                         {
@@ -475,16 +898,16 @@ namespace Ark
                             if (var->valueType() == ValueType::User)
                                 var->usertypeRef().del();
                             *var = Value();
-                            break;
+                            DISPATCH();
                         }
 
                         COZ_PROGRESS_NAMED("ark vm del");
 
                         throwVMError("unbound variable: " + m_state->m_symbols[id]);
-                        break;
+                        DISPATCH();
                     }
 
-                    case Instruction::SAVE_ENV:
+                    TARGET(SAVE_ENV)
                     {
                         /*
                             Argument: none
@@ -493,10 +916,10 @@ namespace Ark
                         m_saved_scope = m_locals.back();
 
                         COZ_PROGRESS_NAMED("ark vm save_scope");
-                        break;
+                        DISPATCH();
                     }
 
-                    case Instruction::GET_FIELD:
+                    TARGET(GET_FIELD)
                     {
                         /*
                             Argument: symbol id (two bytes, big endian)
@@ -504,31 +927,30 @@ namespace Ark
                                 stored in TS. Pop TS and push the value of field read on the stack
                         */
 
-                        ++m_ip;
-                        uint16_t id = readNumber();
+                        uint16_t id = ip->arg;
 
                         Value* var = popAndResolveAsPtr();
                         if (var->valueType() != ValueType::Closure)
                             throwVMError("the variable `" + m_state->m_symbols[m_last_sym_loaded] + "' isn't a closure, can not get the field `" + m_state->m_symbols[id] + "' from it");
 
-                        if (Value* field = (*var->refClosure().scope())[id]; field != nullptr)
+                        if (Scope::Binding* field = findField(var->refClosure(), id, ip->extra); field != nullptr)
                         {
-                            // check for CALL instruction
-                            if (static_cast<std::size_t>(m_ip) + 1 < m_state->m_pages[m_pp].size() && m_state->m_pages[m_pp][m_ip + 1] == Instruction::CALL)
+                            // check for CALL instruction (every page ends with HALT, thus there is always a next one)
+                            if (ip[1].opcode == Instruction::CALL || ip[1].opcode == Instruction::TAIL_CALL)
                             {
                                 m_locals.push_back(var->refClosure().scope());
                                 ++m_scope_count_to_delete.back();
                             }
 
-                            push(field);
-                            break;
+                            push(&field->value, field->is_const);
+                            DISPATCH();
                         }
 
                         throwVMError("couldn't find the variable " + m_state->m_symbols[id] + " in the closure enviroment");
-                        break;
+                        DISPATCH();
                     }
 
-                    case Instruction::PLUGIN:
+                    TARGET(PLUGIN)
                     {
                         /*
                             Argument: constant id (two bytes, big endian)
@@ -536,143 +958,137 @@ namespace Ark
                                  Raise an error if it couldn't find the module.
                         */
 
-                        ++m_ip;
-                        uint16_t id = readNumber();
+                        uint16_t id = ip->arg;
 
                         loadPlugin(id);
 
                         COZ_PROGRESS_NAMED("ark vm plugin");
-                        break;
+                        DISPATCH();
                     }
 
-                    case Instruction::LIST:
+                    TARGET(LIST)
                     {
                         /*
                             Takes at least 0 arguments and push a list on the stack.
                             The content is pushed in reverse order
                         */
-                        ++m_ip;
-                        uint16_t count = readNumber();
+                        uint16_t count = ip->arg;
 
                         Value l(ValueType::List);
                         if (count != 0)
                             l.list().reserve(count);
 
                         for (uint16_t i = 0; i < count; ++i)
-                            l.push_back(*popAndResolveAsPtr());
+                            l.push_back(popValue());
                         push(std::move(l));
 
                         COZ_PROGRESS_NAMED("ark vm list");
-                        break;
+                        DISPATCH();
                     }
 
-                    case Instruction::APPEND:
+                    TARGET(APPEND)
                     {
-                        ++m_ip;
-                        uint16_t count = readNumber();
+                        uint16_t count = ip->arg;
 
-                        Value* list = popAndResolveAsPtr();
-                        if (list->valueType() != ValueType::List)
-                            throw BetterTypeError("append", 1, { *list })
+                        Value obj = popValue();
+                        if (obj.valueType() != ValueType::List)
+                            throw BetterTypeError("append", 1, { obj })
                                 .withArg("list", ValueType::List);
-                        const uint16_t size = list->constList().size();
-
-                        Value obj = Value(*list);
-                        obj.list().reserve(size + count);
 
                         for (uint16_t i = 0; i < count; ++i)
-                            obj.push_back(*popAndResolveAsPtr());
+                            obj.push_back(popValue());
                         push(std::move(obj));
 
                         COZ_PROGRESS_NAMED("ark vm append");
-                        break;
+                        DISPATCH();
                     }
 
-                    case Instruction::CONCAT:
+                    TARGET(CONCAT)
                     {
-                        ++m_ip;
-                        uint16_t count = readNumber();
+                        uint16_t count = ip->arg;
 
-                        Value* list = popAndResolveAsPtr();
-                        if (list->valueType() != ValueType::List)
-                            throw BetterTypeError("concat", 1, { *list })
+                        Value obj = popValue();
+                        if (obj.valueType() != ValueType::List)
+                            throw BetterTypeError("concat", 1, { obj })
                                 .withArg("dst", ValueType::List);
 
-                        Value obj = Value(*list);
-
                         for (uint16_t i = 0; i < count; ++i)
                         {
-                            Value* next = popAndResolveAsPtr();
-                            if (next->valueType() != ValueType::List)
-                                throw BetterTypeError("concat", 2, { *list, *next })
+                            // keep the source alive and unchanged while copying it, it may be the destination list
+                            Value next = popValue();
+                            if (next.valueType() != ValueType::List)
+                                throw BetterTypeError("concat", 2, { obj, next })
                                     .withArg("dst", ValueType::List)
                                     .withArg("src", ValueType::List);
 
-                            for (auto it = next->list().begin(), end = next->list().end(); it != end; ++it)
-                                obj.push_back(*it);
+                            const internal::ListStorage& src = next.constList();
+                            for (std::size_t j = 0, end = src.size(); j < end; ++j)
+                                obj.push_back(src[j]);
                         }
                         push(std::move(obj));
 
                         COZ_PROGRESS_NAMED("ark vm concat");
-                        break;
+                        DISPATCH();
                     }
 
-                    case Instruction::APPEND_IN_PLACE:
+                    TARGET(APPEND_IN_PLACE)
                     {
-                        ++m_ip;
-                        uint16_t count = readNumber();
+                        uint16_t count = ip->arg;
 
-                        Value* list = popAndResolveAsPtr();
+                        Value* list = pop();
 
                         if (list->isConst())
                             throwVMError("can not modify a constant list using `append!'");
+                        list = list->valueType() == ValueType::Reference ? list->reference() : list;
                         if (list->valueType() != ValueType::List)
                             throw BetterTypeError("append!", 1, { *list })
                                 .withArg("dst", ValueType::List);
 
                         for (uint16_t i = 0; i < count; ++i)
-                            list->push_back(*popAndResolveAsPtr());
+                            list->push_back(popValue());
 
                         push(Nil);
 
                         COZ_PROGRESS_NAMED("ark vm append!");
-                        break;
+                        DISPATCH();
                     }
 
-                    case Instruction::CONCAT_IN_PLACE:
+                    TARGET(CONCAT_IN_PLACE)
                     {
-                        ++m_ip;
-                        uint16_t count = readNumber();
+                        uint16_t count = ip->arg;
 
-                        Value* list = popAndResolveAsPtr();
+                        Value* list = pop();
 
                         if (list->isConst())
                             throwVMError("can not modify a constant list using `concat!'");
+                        list = list->valueType() == ValueType::Reference ? list->reference() : list;
                         if (list->valueType() != ValueType::List)
                             throw BetterTypeError("concat!", 1, { *list })
                                 .withArg("dst", ValueType::List);
 
                         for (uint16_t i = 0; i < count; ++i)
                         {
-                            Value* next = popAndResolveAsPtr();
-                            if (next->valueType() != ValueType::List)
-                                throw BetterTypeError("concat!", 2, { *list, *next })
+                            // keep the source alive and unchanged while copying it, it may be the destination list
+                            Value next = popValue();
+                            if (next.valueType() != ValueType::List)
+                                throw BetterTypeError("concat!", 2, { *list, next })
                                     .withArg("dst", ValueType::List)
                                     .withArg("src", ValueType::List);
 
-                            for (auto it = next->list().begin(), end = next->list().end(); it != end; ++it)
-                                list->push_back(*it);
+                            const internal::ListStorage& src = next.constList();
+                            for (std::size_t j = 0, end = src.size(); j < end; ++j)
+                                list->push_back(src[j]);
                         }
 
                         push(Nil);
 
                         COZ_PROGRESS_NAMED("ark vm concat!");
-                        break;
+                        DISPATCH();
                     }
 
-                    case Instruction::POP_LIST:
+                    TARGET(POP_LIST)
                     {
-                        Value list = *popAndResolveAsPtr();
+                        Value list = popValue();
                         Value number = *popAndResolveAsPtr();
 
                         if (list.valueType() != ValueType::List || number.valueType() != ValueType::Number)
@@ -682,161 +1098,281 @@ namespace Ark
 
 
                         long idx = static_cast<long>(number.number());
-                        idx = (idx < 0 ? list.list().size() + idx : idx);
-                        if (static_cast<std::size_t>(idx) >= list.list().size())
+                        idx = (idx < 0 ? list.constList().size() + idx : idx);
+                        if (static_cast<std::size_t>(idx) >= list.constList().size())
                             throw std::runtime_error("pop: index out of range");
 
-                        list.list().erase(list.list().begin() + idx);
-                        push(list);
-                        break;
+                        list.erase(idx);
+                        push(std::move(list));
+                        DISPATCH();
                     }
 
-                    case Instruction::POP_LIST_IN_PLACE:
+                    TARGET(POP_LIST_IN_PLACE)
                     {
-                        Value* list = popAndResolveAsPtr();
+                        Value* list = pop();
                         Value number = *popAndResolveAsPtr();
 
                         if (list->isConst())
                             throwVMError("can not modify a constant list using `pop!'");
+                        list = list->valueType() == ValueType::Reference ? list->reference() : list;
                         if (list->valueType() != ValueType::List || number.valueType() != ValueType::Number)
                             throw BetterTypeError("pop!", 2, { *list, number })
                                 .withArg("list", ValueType::List)
                                 .withArg("idx", ValueType::Number);
 
                         long idx = static_cast<long>(number.number());
-                        idx = (idx < 0 ? list->list().size() + idx : idx);
-                        if (static_cast<std::size_t>(idx) >= list->list().size())
+                        idx = (idx < 0 ? list->constList().size() + idx : idx);
+                        if (static_cast<std::size_t>(idx) >= list->constList().size())
                             throw std::runtime_error("pop!: index out of range");
 
-                        list->list().erase(list->list().begin() + idx);
-                        break;
+                        list->erase(idx);
+                        DISPATCH();
                     }
 
 #pragma endregion
 
 #pragma region "Operators"
 
-                    case Instruction::ADD:
+                    TARGET(LOAD_LOCAL)
                     {
-                        Value *b = popAndResolveAsPtr(), *a = popAndResolveAsPtr();
+                        /*
+                            Argument: local variable slot (two bytes, big endian)
+                            Job: Load a variable of the current frame onto the stack, without searching for it. If the
+                                    slot wasn't assigned yet, search the variable in the enclosing scopes
+                        */
 
-                        if (a->valueType() == ValueType::Number)
-                        {
-                            if (b->valueType() != ValueType::Number)
-                                throw BetterTypeError("+", 2, { *a, *b })
-                                    .withArg("a", ValueType::Number)
-                                    .withArg("b", ValueType::Number);
+                        uint16_t slot = ip->arg;
+                        m_last_sym_loaded = ip->extra;
 
-                            push(Value(a->number() + b->number()));
-                            break;
-                        }
-                        else if (a->valueType() == ValueType::String)
-                        {
-                            if (b->valueType() != ValueType::String)
-                                throw BetterTypeError("+", 2, { *a, *b })
-                                    .withArg("a", ValueType::String)
-                                    .withArg("b", ValueType::String);
+                        Scope::Binding* var = nullptr;
+                        if (Scope& frame = *m_locals.back(); slot < frame.m_data.size() && frame.m_data[slot].id == ip->extra)
+                            var = &frame.m_data[slot];
+                        else
+                            var = findNearestBinding(m_last_sym_loaded);
 
-                            push(Value(a->string() + b->string()));
-                            break;
-                        }
-                        throw BetterTypeError("+", 2, { *a, *b })
-                            .withArg("a", { ValueType::Number, ValueType::String })
-                            .withArg("b", { ValueType::Number, ValueType::String });
+                        if (var != nullptr)
+                            push(&var->value, var->is_const);
+                        else
+                            throwVMError("unbound variable: " + m_state->m_symbols[m_last_sym_loaded]);
+
+                        COZ_PROGRESS_NAMED("ark vm load_local");
+                        DISPATCH();
                     }
 
-                    case Instruction::SUB:
+                    TARGET(STORE_LOCAL)
                     {
-                        Value *b = popAndResolveAsPtr(), *a = popAndResolveAsPtr();
+                        /*
+                            Argument: local variable slot (two bytes, big endian)
+                            Job: Take the value on top of the stack and put it inside a variable of the current frame.
+                                    If the slot wasn't assigned yet, search the variable in the enclosing scopes and
+                                    raise an error if it couldn't be found
+                        */
 
-                        if (a->valueType() != ValueType::Number || b->valueType() != ValueType::Number)
-                            throw BetterTypeError("-", 2, { *a, *b })
-                                .withArg("a", ValueType::Number)
-                                .withArg("b", ValueType::Number);
+                        findStoreTarget(*ip)->value = popValue();
 
-                        push(Value(a->number() - b->number()));
-                        break;
+                        COZ_PROGRESS_NAMED("ark vm store_local");
+                        DISPATCH();
                     }
 
-                    case Instruction::MUL:
+                    TARGET(SET_LOCAL)
                     {
-                        Value *b = popAndResolveAsPtr(), *a = popAndResolveAsPtr();
+                        /*
+                            Argument: local variable slot (two bytes, big endian)
+                            Job: Take the value on top of the stack and put it in a slot of the current frame, creating
+                                    a mutable variable
+                        */
+
+                        uint16_t id = ip->extra;
+                        Scope& frame = *m_locals.back();
+
+                        Scope::Binding* local = nullptr;
+                        if (ip->arg < frame.m_data.size() && (frame.m_data[ip->arg].id == id || frame.m_data[ip->arg].id == Scope::UnboundId))
+                            local = &frame.m_data[ip->arg];
+                        else
+                            local = frame.binding(id);
 
-                        if (a->valueType() != ValueType::Number || b->valueType() != ValueType::Number)
-                            throw BetterTypeError("*", 2, { *a, *b })
-                                .withArg("a", ValueType::Number)
-                                .withArg("b", ValueType::Number);
+                        if (local == nullptr)
+                            frame.push_back(id, popValue());
+                        else
+                        {
+                            local->id = id;
+                            local->value = popValue();
+                            local->is_const = false;
+                        }
 
-                        push(Value(a->number() * b->number()));
-                        break;
+                        COZ_PROGRESS_NAMED("ark vm set_local");
+                        DISPATCH();
                     }
 
-                    case Instruction::DIV:
+                    TARGET(LET_LOCAL)
                     {
-                        Value *b = popAndResolveAsPtr(), *a = popAndResolveAsPtr();
+                        /*
+                            Argument: local variable slot (two bytes, big endian)
+                            Job: Take the value on top of the stack and put it in a slot of the current frame, creating
+                                    a constant
+                        */
 
-                        if (a->valueType() != ValueType::Number || b->valueType() != ValueType::Number)
-                            throw BetterTypeError("/", 2, { *a, *b })
-                                .withArg("a", ValueType::Number)
-                                .withArg("b", ValueType::Number);
+                        uint16_t id = ip->extra;
+                        Scope& frame = *m_locals.back();
 
-                        auto d = b->number();
-                        if (d == 0)
-                            throw ZeroDivisionError();
+                        // check if we are redefining a variable
+                        if (ip->arg < frame.m_data.size() && frame.m_data[ip->arg].id == Scope::UnboundId)
+                        {
+                            Scope::Binding& local = frame.m_data[ip->arg];
+                            local.value = popValue();
+                            local.id = id;
+                            local.is_const = true;
+                        }
+                        else if (frame.binding(id) != nullptr)
+                            throwVMError("can not use 'let' to redefine the variable " + m_state->m_symbols[id]);
+                        else
+                            frame.push_back(id, popValue(), /* is_const */ true);
 
-                        push(Value(a->number() / d));
-                        break;
+                        COZ_PROGRESS_NAMED("ark vm let_local");
+                        DISPATCH();
                     }
 
-                    case Instruction::GT:
+                    TARGET(ADD)
                     {
-                        Value *b = popAndResolveAsPtr(), *a = popAndResolveAsPtr();
-
-                        push((!(*a == *b) && !(*a < *b)) ? Builtins::trueSym : Builtins::falseSym);
-                        break;
+                        uint8_t& op = operators[ip->extra];
+                        if (op & QuickenedOperator)
+                            numberOperator<Instruction::ADD>(op);
+                        else
+                        {
+                            Value *b = popAndResolveAsPtr(), *a = popAndResolveAsPtr();
+                            quicken(op, a, b);
+                            push(binaryOperator<Instruction::ADD>(a, b));
+                        }
+                        DISPATCH();
                     }
 
-                    case Instruction::LT:
+                    TARGET(SUB)
                     {
-                        Value *b = popAndResolveAsPtr(), *a = popAndResolveAsPtr();
-
-                        push((*a < *b) ? Builtins::trueSym : Builtins::falseSym);
-                        break;
+                        uint8_t& op = operators[ip->extra];
+                        if (op & QuickenedOperator)
+                            numberOperator<Instruction::SUB>(op);
+                        else
+                        {
+                            Value *b = popAndResolveAsPtr(), *a = popAndResolveAsPtr();
+                            quicken(op, a, b);
+                            push(binaryOperator<Instruction::SUB>(a, b));
+                        }
+                        DISPATCH();
                     }
 
-                    case Instruction::LE:
+                    TARGET(MUL)
                     {
-                        Value *b = popAndResolveAsPtr(), *a = popAndResolveAsPtr();
+                        uint8_t& op = operators[ip->extra];
+                        if (op & QuickenedOperator)
+                            numberOperator<Instruction::MUL>(op);
+                        else
+                        {
+                            Value *b = popAndResolveAsPtr(), *a = popAndResolveAsPtr();
+                            quicken(op, a, b);
+                            push(binaryOperator<Instruction::MUL>(a, b));
+                        }
+                        DISPATCH();
+                    }
 
-                        push(((*a < *b) || (*a == *b)) ? Builtins::trueSym : Builtins::falseSym);
-                        break;
+                    TARGET(DIV)
+                    {
+                        uint8_t& op = operators[ip->extra];
+                        if (op & QuickenedOperator)
+                            numberOperator<Instruction::DIV>(op);
+                        else
+                        {
+                            Value *b = popAndResolveAsPtr(), *a = popAndResolveAsPtr();
+                            quicken(op, a, b);
+                            push(binaryOperator<Instruction::DIV>(a, b));
+                        }
+                        DISPATCH();
                     }
 
-                    case Instruction::GE:
+                    TARGET(GT)
                     {
-                        Value *b = popAndResolveAsPtr(), *a = popAndResolveAsPtr();
+                        uint8_t& op = operators[ip->extra];
+                        if (op & QuickenedOperator)
+                            numberOperator<Instruction::GT>(op);
+                        else
+                        {
+                            Value *b = popAndResolveAsPtr(), *a = popAndResolveAsPtr();
+                            quicken(op, a, b);
+                            push(binaryOperator<Instruction::GT>(a, b));
+                        }
+                        DISPATCH();
+                    }
 
-                        push(!(*a < *b) ? Builtins::trueSym : Builtins::falseSym);
-                        break;
+                    TARGET(LT)
+                    {
+                        uint8_t& op = operators[ip->extra];
+                        if (op & QuickenedOperator)
+                            numberOperator<Instruction::LT>(op);
+                        else
+                        {
+                            Value *b = popAndResolveAsPtr(), *a = popAndResolveAsPtr();
+                            quicken(op, a, b);
+                            push(binaryOperator<Instruction::LT>(a, b));
+                        }
+                        DISPATCH();
                     }
 
-                    case Instruction::NEQ:
+                    TARGET(LE)
                     {
-                        Value *b = popAndResolveAsPtr(), *a = popAndResolveAsPtr();
+                        uint8_t& op = operators[ip->extra];
+                        if (op & QuickenedOperator)
+                            numberOperator<Instruction::LE>(op);
+                        else
+                        {
+                            Value *b = popAndResolveAsPtr(), *a = popAndResolveAsPtr();
+                            quicken(op, a, b);
+                            push(binaryOperator<Instruction::LE>(a, b));
+                        }
+                        DISPATCH();
+                    }
 
-                        push((*a != *b) ? Builtins::trueSym : Builtins::falseSym);
-                        break;
+                    TARGET(GE)
+                    {
+                        uint8_t& op = operators[ip->extra];
+                        if (op & QuickenedOperator)
+                            numberOperator<Instruction::GE>(op);
+                        else
+                        {
+                            Value *b = popAndResolveAsPtr(), *a = popAndResolveAsPtr();
+                            quicken(op, a, b);
+                            push(binaryOperator<Instruction::GE>(a, b));
+                        }
+                        DISPATCH();
                     }
 
-                    case Instruction::EQ:
+                    TARGET(NEQ)
                     {
-                        Value *b = popAndResolveAsPtr(), *a = popAndResolveAsPtr();
+                        uint8_t& op = operators[ip->extra];
+                        if (op & QuickenedOperator)
+                            numberOperator<Instruction::NEQ>(op);
+                        else
+                        {
+                            Value *b = popAndResolveAsPtr(), *a = popAndResolveAsPtr();
+                            quicken(op, a, b);
+                            push(binaryOperator<Instruction::NEQ>(a, b));
+                        }
+                        DISPATCH();
+                    }
 
-                        push((*a == *b) ? Builtins::trueSym : Builtins::falseSym);
-                        break;
+                    TARGET(EQ)
+                    {
+                        uint8_t& op = operators[ip->extra];
+                        if (op & QuickenedOperator)
+                            numberOperator<Instruction::EQ>(op);
+                        else
+                        {
+                            Value *b = popAndResolveAsPtr(), *a = popAndResolveAsPtr();
+                            quicken(op, a, b);
+                            push(binaryOperator<Instruction::EQ>(a, b));
+                        }
+                        DISPATCH();
                     }
 
-                    case Instruction::LEN:
+                    TARGET(LEN)
                     {
                         Value* a = popAndResolveAsPtr();
 
@@ -847,10 +1383,10 @@ namespace Ark
                         else
                             throw BetterTypeError("len", 1, { *a })
                                 .withArg("src", { ValueType::List, ValueType::String });
-                        break;
+                        DISPATCH();
                     }
 
-                    case Instruction::EMPTY:
+                    TARGET(EMPTY)
                     {
                         Value* a = popAndResolveAsPtr();
 
@@ -862,46 +1398,38 @@ namespace Ark
                             throw BetterTypeError("empty?", 1, { *a })
                                 .withArg("src", { ValueType::List, ValueType::String });
 
-                        break;
+                        DISPATCH();
                     }
 
-                    case Instruction::TAIL:
+                    TARGET(TAIL)
                     {
-                        Value* a = popAndResolveAsPtr();
+                        Value a = popValue();
 
-                        if (a->valueType() == ValueType::List)
+                        if (a.valueType() == ValueType::List)
                         {
-                            if (a->constList().size() < 2)
-                            {
-                                push(Value(ValueType::List));
-                                break;
-                            }
-
-                            std::vector<Value> tmp(a->constList().size() - 1);
-                            for (std::size_t i = 1, end = a->constList().size(); i < end; ++i)
-                                tmp[i - 1] = a->constList()[i];
-                            push(Value(std::move(tmp)));
+                            if (a.constList().size() < 2)
+                                a = Value(ValueType::List);
+                            else
+                                // a temporary list is modified in place, a shared one is copied first (in O(1) when persistent)
+                                a.erase(0);
+                            push(std::move(a));
                         }
-                        else if (a->valueType() == ValueType::String)
+                        else if (a.valueType() == ValueType::String)
                         {
-                            if (a->string().size() < 2)
-                            {
-                                push(Value(ValueType::String));
-                                break;
-                            }
-
-                            Value b = *a;
-                            b.stringRef().erase_front(0);
-                            push(std::move(b));
+                            if (a.string().size() < 2)
+                                a = Value(ValueType::String);
+                            else
+                                a.stringRef().erase_front(0);
+                            push(std::move(a));
                         }
                         else
-                            throw BetterTypeError("tail", 1, { *a })
+                            throw BetterTypeError("tail", 1, { a })
                                 .withArg("src", { ValueType::List, ValueType::String });
 
-                        break;
+                        DISPATCH();
                     }
 
-                    case Instruction::HEAD:
+                    TARGET(HEAD)
                     {
                         Value* a = popAndResolveAsPtr();
 
@@ -910,37 +1438,36 @@ namespace Ark
                             if (a->constList().size() == 0)
                             {
                                 push(Builtins::nil);
-                                break;
+                                DISPATCH();
                             }
 
-                            Value b = a->constList()[0];
-                            push(b);
+                            push(a->constList()[0]);
                         }
                         else if (a->valueType() == ValueType::String)
                         {
                             if (a->string().size() == 0)
                             {
                                 push(Value(ValueType::String));
-                                break;
+                                DISPATCH();
                             }
 
-                            push(Value(std::string(1, a->stringRef()[0])));
+                            push(Value(std::string(1, a->string()[0])));
                         }
                         else
                             throw BetterTypeError("head", 1, { *a })
                                 .withArg("src", { ValueType::List, ValueType::String });
 
-                        break;
+                        DISPATCH();
                     }
 
-                    case Instruction::ISNIL:
+                    TARGET(ISNIL)
                     {
                         Value* a = popAndResolveAsPtr();
                         push((*a == Builtins::nil) ? Builtins::trueSym : Builtins::falseSym);
-                        break;
+                        DISPATCH();
                     }
 
-                    case Instruction::ASSERT:
+                    TARGET(ASSERT)
                     {
                         Value *b = popAndResolveAsPtr(), *a = popAndResolveAsPtr();
 
@@ -952,12 +1479,12 @@ namespace Ark
                                     .withArg("expr", ValueType::False)
                                     .withArg("msg", ValueType::String);
 
-                            throw AssertionFailed(b->stringRef().toString());
+                            throw AssertionFailed(std::string(b->string().c_str()));
                         }
-                        break;
+                        DISPATCH();
                     }
 
-                    case Instruction::TO_NUM:
+                    TARGET(TO_NUM)
                     {
                         Value* a = popAndResolveAsPtr();
 
@@ -970,79 +1497,77 @@ namespace Ark
                             push(Value(val));
                         else
                             push(Builtins::nil);
-                        break;
+                        DISPATCH();
                     }
 
-                    case Instruction::TO_STR:
+                    TARGET(TO_STR)
                     {
-                        std::stringstream ss;
                         Value* a = popAndResolveAsPtr();
-                        ss << (*a);
-                        push(Value(ss.str()));
-                        break;
+                        {
+                            std::stringstream ss;
+                            ss << (*a);
+                            push(Value(ss.str()));
+                        }
+                        DISPATCH();
                     }
 
-                    case Instruction::AT:
+                    TARGET(AT)
                     {
                         Value* b = popAndResolveAsPtr();
-                        Value a = *popAndResolveAsPtr();  // be careful, it's not a pointer
-
-                        if (b->valueType() != ValueType::Number)
-                            throw BetterTypeError("@", 2, { *b, a })
-                                .withArg("src", { ValueType::List, ValueType::String })
-                                .withArg("idx", ValueType::Number);
-
-                        long idx = static_cast<long>(b->number());
+                        {
+                            Value a = popValue();  // be careful, it's not a pointer
 
-                        if (a.valueType() == ValueType::List)
-                            push(a.list()[idx < 0 ? a.list().size() + idx : idx]);
-                        else if (a.valueType() == ValueType::String)
-                            push(Value(std::string(1, a.string()[idx < 0 ? a.string().size() + idx : idx])));
-                        else
-                            throw BetterTypeError("@", 2, { *b, a })
-                                .withArg("src", { ValueType::List, ValueType::String })
-                                .withArg("idx", ValueType::Number);
-                        break;
+                            if (b->valueType() != ValueType::Number)
+                                throw BetterTypeError("@", 2, { *b, a })
+                                    .withArg("src", { ValueType::List, ValueType::String })
+                                    .withArg("idx", ValueType::Number);
+
+                            long idx = static_cast<long>(b->number());
+
+                            if (a.valueType() == ValueType::List)
+                                push(a.constList()[idx < 0 ? a.constList().size() + idx : idx]);
+                            else if (a.valueType() == ValueType::String)
+                                push(Value(std::string(1, a.string()[idx < 0 ? a.string().size() + idx : idx])));
+                            else
+                                throw BetterTypeError("@", 2, { *b, a })
+                                    .withArg("src", { ValueType::List, ValueType::String })
+                                    .withArg("idx", ValueType::Number);
+                        }
+                        DISPATCH();
                     }
 
-                    case Instruction::AND_:
+                    TARGET(AND_)
                     {
                         Value *a = popAndResolveAsPtr(), *b = popAndResolveAsPtr();
 
                         push((*a == Builtins::trueSym && *b == Builtins::trueSym) ? Builtins::trueSym : Builtins::falseSym);
-                        break;
+                        DISPATCH();
                     }
 
-                    case Instruction::OR_:
+                    TARGET(OR_)
                     {
                         Value *a = popAndResolveAsPtr(), *b = popAndResolveAsPtr();
 
                         push((*b == Builtins::trueSym || *a == Builtins::trueSym) ? Builtins::trueSym : Builtins::falseSym);
-                        break;
+                        DISPATCH();
                     }
 
-                    case Instruction::MOD:
+                    TARGET(MOD)
                     {
                         Value *b = popAndResolveAsPtr(), *a = popAndResolveAsPtr();
-
-                        if (a->valueType() != ValueType::Number)
-                            throw TypeError("Arguments of mod should be Numbers");
-                        if (b->valueType() != ValueType::Number)
-                            throw TypeError("Arguments of mod should be Numbers");
-
-                        push(Value(std::fmod(a->number(), b->number())));
-                        break;
+                        push(binaryOperator<Instruction::MOD>(a, b));
+                        DISPATCH();
                     }
 
-                    case Instruction::TYPE:
+                    TARGET(TYPE)
                     {
                         Value* a = popAndResolveAsPtr();
 
                         push(Value(types_to_str[static_cast<unsigned>(a->valueType())]));
-                        break;
+                        DISPATCH();
                     }
 
-                    case Instruction::HASFIELD:
+                    TARGET(HASFIELD)
                     {
                         Value *field = popAndResolveAsPtr(), *closure = popAndResolveAsPtr();
 
@@ -1051,58 +1576,139 @@ namespace Ark
                         if (field->valueType() != ValueType::String)
                             throw TypeError("Argument no 2 of hasField should be a String");
 
-                        auto it = std::find(m_state->m_symbols.begin(), m_state->m_symbols.end(), field->stringRef().toString());
-                        if (it == m_state->m_symbols.end())
-                        {
-                            push(Builtins::falseSym);
-                            break;
-                        }
-
-                        uint16_t id = static_cast<uint16_t>(std::distance(m_state->m_symbols.begin(), it));
-                        push((*closure->refClosure().refScope())[id] != nullptr ? Builtins::trueSym : Builtins::falseSym);
+                        auto id = m_state->symbolId(std::string_view(field->string().c_str(), field->string().size()));
+                        push(id && (*closure->refClosure().refScope())[id.value()] != nullptr ? Builtins::trueSym : Builtins::falseSym);
 
-                        break;
+                        DISPATCH();
                     }
 
-                    case Instruction::NOT:
+                    TARGET(NOT)
                     {
                         Value* a = popAndResolveAsPtr();
 
                         push(!(*a) ? Builtins::trueSym : Builtins::falseSym);
-                        break;
+                        DISPATCH();
+                    }
+
+#pragma endregion
+
+#pragma region "Superinstructions"
+
+                    TARGET(LOAD_LOAD_OP)
+                    {
+                        /*
+                            Replaces: LOAD_x a, LOAD_y b, op
+                            Job: Apply the binary operator to the two operands without putting them on the stack
+                        */
+
+                        Value* a = loadOperand(ip[0]);
+                        Value* b = loadOperand(ip[1]);
+                        push(binaryOperator(ip[2].unfused, a, b));
+
+                        ip += 2;
+                        DISPATCH();
+                    }
+
+                    TARGET(LOAD_LOAD_OP_STORE)
+                    {
+                        /*
+                            Replaces: LOAD_x a, LOAD_y b, op, STORE_z c
+                            Job: Apply the binary operator to the two operands and store the result in a variable
+                        */
+
+                        Value* a = loadOperand(ip[0]);
+                        Value* b = loadOperand(ip[1]);
+                        Value result = binaryOperator(ip[2].unfused, a, b);
+                        findStoreTarget(ip[3])->value = std::move(result);
+
+                        ip += 3;
+                        DISPATCH();
+                    }
+
+                    TARGET(LOAD_LOAD_CMP_JUMP)
+                    {
+                        /*
+                            Replaces: LOAD_x a, LOAD_y b, comparison, POP_JUMP_IF_(TRUE|FALSE) address
+                            Job: Compare the two operands and jump following the result
+                        */
+
+                        Value* a = loadOperand(ip[0]);
+                        Value* b = loadOperand(ip[1]);
+                        bool result = compare(ip[2].unfused, a, b);
+
+                        if (result == (ip[3].unfused == Instruction::POP_JUMP_IF_TRUE))
+                            JUMP_TO(ip[3].arg);
+
+                        ip += 3;
+                        DISPATCH();
+                    }
+
+                    TARGET(CALL_BUILTIN)
+                    {
+                        /*
+                            Replaces: BUILTIN id, CALL argc (or TAIL_CALL argc)
+                            Job: Call the builtin function with the arguments on the stack
+                        */
+
+                        const Value& function = Builtins::builtins[ip->arg].second;
+                        // same as CALL, the error handler and a nested safeRun need m_ip
+                        m_ip = static_cast<int>(ip - page) + 1;
+                        page = nullptr;
+                        callProc(function, ip[1].arg);
+                        page = codePage(m_pp);
+                        ip = page + (m_ip + 1);
+                        continue;
                     }
 
 #pragma endregion
 
                     default:
-                        throwVMError("unknown instruction: " + std::to_string(static_cast<std::size_t>(inst)));
-                        break;
+#ifdef ARK_USE_COMPUTED_GOTO
+                    TARGET_UNKNOWN:
+#endif
+                        throwVMError("unknown instruction: " + std::to_string(static_cast<std::size_t>(ip->opcode)));
                 }
-
-                // move forward
-                ++m_ip;
             }
-        }
-        catch (const std::exception& e)
-        {
-            std::printf("%s\n", e.what());
-            backtrace();
-            m_exit_code = 1;
+
+            m_ip = static_cast<int>(ip - page);
+            m_until_frame_count = enclosing_frame_count;
         }
         catch (...)
         {
-            std::printf("Unknown error\n");
-            backtrace();
-            m_exit_code = 1;
+            // the error handlers need the instruction which failed
+            if (page != nullptr)
+                m_ip = static_cast<int>(ip - page);
+            m_until_frame_count = enclosing_frame_count;
+            throw;
         }
-
-        return m_exit_code;
     }
 
     // ------------------------------------------
     //             error handling
     // ------------------------------------------
 
+    void VM::unwind(std::size_t frames_count, std::size_t sp, std::size_t locals_count) noexcept
+    {
+        // leave the frames like RET, the page and instruction pointers are at the bottom of each frame
+        while (m_fc > frames_count && m_sp > sp + 1)
+        {
+            while (m_sp > sp + 1 && (*m_stack)[m_sp - 1].valueType() != ValueType::InstPtr)
+                --m_sp;
+            m_sp -= 2;
+            returnFromFuncCall();
+        }
+        m_fc = frames_count;
+
+        // an error raised while entering a function can leave its scopes
+        while (m_locals.size() > locals_count)
+            popScope();
+        m_scope_count_to_delete.resize(frames_count);
+        m_scope_count_to_delete.back() = 0;
+        m_saved_scope.reset();
+
+        m_sp = sp;
+    }
+
     uint16_t VM::findNearestVariableIdWithValue(Value&& value) noexcept
     {
         for (auto it = m_locals.rbegin(), it_end = m_locals.rend(); it != it_end; ++it)
@@ -1129,7 +1735,7 @@ namespace Ark
         if (m_fc > 1)
         {
             // display call stack trace
-            uint16_t it = m_fc;
+            std::size_t it = m_fc;
             Scope old_scope = *m_locals.back().get();
 
             while (it != 0)
@@ -1137,8 +1743,10 @@ namespace Ark
                 std::cerr << "[" << termcolor::cyan << it << termcolor::reset << "] ";
                 if (m_pp != 0)
                 {
-                    uint16_t id = findNearestVariableIdWithValue(
-                        Value(static_cast<PageAddr_t>(m_pp)));
+                    // functions bound to a variable know their name, the others are searched by value
+                    uint16_t id = m_state->function(m_pp).name;
+                    if (id >= m_state->m_symbols.size())
+                        id = findNearestVariableIdWithValue(Value(static_cast<PageAddr_t>(m_pp)));
 
                     if (id < m_state->m_symbols.size())
                         std::cerr << "In function `" << termcolor::green << m_state->m_symbols[id] << termcolor::reset << "'\n";
@@ -1172,8 +1780,12 @@ namespace Ark
             // display variables values in the current scope
             std::printf("\nCurrent scope variables values:\n");
             for (std::size_t i = 0, size = old_scope.size(); i < size; ++i)
-                std::cerr << termcolor::cyan << m_state->m_symbols[old_scope.m_data[i].first] << termcolor::reset
-                          << " = " << old_scope.m_data[i].second << "\n";
+            {
+                if (old_scope.m_data[i].id == Scope::UnboundId)
+                    continue;
+                std::cerr << termcolor::cyan << m_state->m_symbols[old_scope.m_data[i].id] << termcolor::reset
+                          << " = " << old_scope.m_data[i].value << "\n";
+            }
 
             while (m_fc != 1)
             {
@@ -1188,3 +1800,12 @@ namespace Ark
         }
     }
 }
+
+#undef TARGET
+#undef DISPATCH_GOTO
+#undef DISPATCH
+#undef JUMP_TO
+
+#ifdef ARK_USE_COMPUTED_GOTO
+#    pragma GCC diagnostic pop
+#endif
@@ -2,23 +2,25 @@
 
 #include <Ark/Utils.hpp>
 
-#define init_const_type(is_const, type) ((is_const ? (1 << 7) : 0) | static_cast<uint8_t>(type))
-
 namespace Ark
 {
+    static_assert(sizeof(Value) == 8, "Value should be NaN-boxed on 8 bytes");
+
     Value::Value() noexcept :
-        m_const_type(init_const_type(false, ValueType::Undefined))
+        m_bits(box(ValueType::Undefined, 0))
     {}
 
     // --------------------------
 
     Value::Value(ValueType type) noexcept :
-        m_const_type(init_const_type(false, type))
+        m_bits(box(type, 0))
     {
         if (type == ValueType::List)
-            m_value = std::vector<Value>();
+            m_bits = box(type, reinterpret_cast<uint64_t>(new internal::ValueBox<internal::ListStorage>()));
         else if (type == ValueType::String)
-            m_value = "";
+            m_bits = box(type, reinterpret_cast<uint64_t>(new internal::ValueBox<String> { String("") }));
+        else if (type == ValueType::Number)
+            m_bits = 0;  // 0.0
 
 #ifdef ARK_PROFILER_COUNT
         value_creations++;
@@ -29,121 +31,273 @@ namespace Ark
     extern unsigned value_creations = 0;
     extern unsigned value_copies = 0;
     extern unsigned value_moves = 0;
-
-    Value::Value(const Value& val) noexcept :
-        m_value(val.m_value),
-        m_const_type(val.m_const_type)
-    {
-        if (valueType() != ValueType::Reference)
-            value_copies++;
-    }
-
-    Value::Value(Value&& other) noexcept
-    {
-        m_value = std::move(other.m_value);
-        m_const_type = std::move(other.m_const_type);
-
-        if (valueType() != ValueType::Reference)
-            value_moves++;
-    }
-
-    Value& Value::operator=(const Value& other) noexcept
-    {
-        m_value = other.m_value;
-        m_const_type = other.m_const_type;
-
-        if (valueType() != ValueType::Reference)
-            value_copies++;
-
-        return *this;
-    }
 #endif
 
     Value::Value(int value) noexcept :
-        m_const_type(init_const_type(false, ValueType::Number)), m_value(static_cast<double>(value))
+        Value(static_cast<double>(value))
     {}
 
     Value::Value(float value) noexcept :
-        m_const_type(init_const_type(false, ValueType::Number)), m_value(static_cast<double>(value))
+        Value(static_cast<double>(value))
     {}
 
-    Value::Value(double value) noexcept :
-        m_const_type(init_const_type(false, ValueType::Number)), m_value(value)
-    {}
+    Value::Value(double value) noexcept
+    {
+        // NaNs with the sign bit set would collide with the boxed values
+        if (value != value)
+            m_bits = CanonicalNaN;
+        else
+            std::memcpy(&m_bits, &value, sizeof(double));
+    }
 
     Value::Value(const std::string& value) noexcept :
-        m_const_type(init_const_type(false, ValueType::String)), m_value(value.c_str())
+        Value(String(value.c_str()))
     {}
 
     Value::Value(const String& value) noexcept :
-        m_const_type(init_const_type(false, ValueType::String)), m_value(value)
+        m_bits(box(ValueType::String, reinterpret_cast<uint64_t>(new internal::ValueBox<String> { value })))
     {}
 
     Value::Value(const char* value) noexcept :
-        m_const_type(init_const_type(false, ValueType::String)), m_value(value)
+        Value(String(value))
     {}
 
     Value::Value(internal::PageAddr_t value) noexcept :
-        m_const_type(init_const_type(false, ValueType::PageAddr)), m_value(value)
+        m_bits(box(ValueType::PageAddr, value))
     {}
 
     Value::Value(Value::ProcType value) noexcept :
-        m_const_type(init_const_type(false, ValueType::CProc)), m_value(value)
+        m_bits(box(ValueType::CProc, reinterpret_cast<uint64_t>(value)))
+    {}
+
+    Value::Value(Value::LegacyProcType value) noexcept :
+        m_bits(box(ValueType::CProc, reinterpret_cast<uint64_t>(value) | LegacyProcFlag))
     {}
 
     Value::Value(std::vector<Value>&& value) noexcept :
-        m_const_type(init_const_type(false, ValueType::List)), m_value(value)
+        m_bits(box(ValueType::List, reinterpret_cast<uint64_t>(new internal::ValueBox<internal::ListStorage> { internal::ListStorage(std::move(value)) })))
     {}
 
     Value::Value(internal::Closure&& value) noexcept :
-        m_const_type(init_const_type(false, ValueType::Closure)), m_value(value)
+        m_bits(box(ValueType::Closure, reinterpret_cast<uint64_t>(new internal::ValueBox<internal::Closure> { std::move(value) })))
     {}
 
     Value::Value(UserType&& value) noexcept :
-        m_const_type(init_const_type(false, ValueType::User)), m_value(value)
+        m_bits(box(ValueType::User, reinterpret_cast<uint64_t>(new internal::ValueBox<UserType> { std::move(value) })))
     {}
 
     Value::Value(Value* ref) noexcept :
-        m_const_type(init_const_type(true, ValueType::Reference)), m_value(ref)
+        m_bits(box(ValueType::Reference, reinterpret_cast<uint64_t>(ref) | 1))
     {}
 
     // --------------------------
 
+    namespace
+    {
+        template <typename Cell>
+        inline void retain(Cell* cell) noexcept
+        {
+            // the frozen cells are owned by a State, the virtual machines sharing it only read them
+            if (cell->refcount.load(std::memory_order_relaxed) != internal::FrozenRefcount)
+                cell->refcount.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        template <typename Cell>
+        inline void drop(Cell* cell) noexcept
+        {
+            if (cell->refcount.load(std::memory_order_relaxed) != internal::FrozenRefcount && cell->refcount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                delete cell;
+        }
+    }
+
+    void Value::acquire() noexcept
+    {
+        // the heap objects are shared by every copy, strings and lists being copied on write (see unshare)
+        switch (valueType())
+        {
+            case ValueType::String:
+                retain(payloadAs<internal::ValueBox<String>>());
+                break;
+
+            case ValueType::List:
+                retain(payloadAs<internal::ValueBox<internal::ListStorage>>());
+                break;
+
+            case ValueType::Closure:
+                retain(payloadAs<internal::ValueBox<internal::Closure>>());
+                break;
+
+            case ValueType::User:
+                retain(payloadAs<internal::ValueBox<UserType>>());
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    void Value::release() noexcept
+    {
+        switch (valueType())
+        {
+            case ValueType::String:
+                drop(payloadAs<internal::ValueBox<String>>());
+                break;
+
+            case ValueType::List:
+                drop(payloadAs<internal::ValueBox<internal::ListStorage>>());
+                break;
+
+            case ValueType::Closure:
+                drop(payloadAs<internal::ValueBox<internal::Closure>>());
+                break;
+
+            case ValueType::User:
+                drop(payloadAs<internal::ValueBox<UserType>>());
+                break;
+
+            default:
+                break;
+        }
+        m_bits = box(ValueType::Undefined, 0);
+    }
+
+    template <typename T>
+    T& Value::unshare()
+    {
+        auto cell = payloadAs<internal::ValueBox<T>>();
+        if (cell->refcount.load(std::memory_order_acquire) != 1)
+        {
+            m_bits = box(valueType(), reinterpret_cast<uint64_t>(new internal::ValueBox<T> { cell->data }));
+            drop(cell);
+        }
+        return boxed<T>();
+    }
+
+    internal::ListStorage& Value::unshareList()
+    {
+        auto cell = payloadAs<internal::ValueBox<internal::ListStorage>>();
+        if (cell->refcount.load(std::memory_order_acquire) != 1)
+        {
+            // a big list is copied in a persistent vector, sharing its elements with the other copies once it is persistent itself
+            auto copy = cell->data.size() >= ArkPersistentListThreshold ?
+                new internal::ValueBox<internal::ListStorage> { internal::ListStorage(cell->data.persistentCopy()) } :
+                new internal::ValueBox<internal::ListStorage> { cell->data };
+            m_bits = box(ValueType::List, reinterpret_cast<uint64_t>(copy));
+            drop(cell);
+        }
+        return boxed<internal::ListStorage>();
+    }
+
+    Value Value::thawed() const
+    {
+        if (valueType() == ValueType::String)
+        {
+            auto cell = payloadAs<internal::ValueBox<String>>();
+            if (cell->refcount.load(std::memory_order_relaxed) != internal::FrozenRefcount)
+                return *this;
+
+            Value copy(cell->data);
+            copy.payloadAs<internal::ValueBox<String>>()->hash = cell->hash;
+            return copy;
+        }
+        else if (valueType() == ValueType::List)
+        {
+            // the list is copied only if one of its elements changes
+            const internal::ListStorage& list = constList();
+            std::vector<Value> copy;
+            bool copied = false;
+
+            for (std::size_t i = 0, size = list.size(); i < size; ++i)
+            {
+                Value element = list[i].thawed();
+                if (!copied && element.m_bits != list[i].m_bits)
+                {
+                    copy.reserve(size);
+                    for (std::size_t j = 0; j < i; ++j)
+                        copy.push_back(list[j]);
+                    copied = true;
+                }
+                if (copied)
+                    copy.push_back(std::move(element));
+            }
+
+            if (copied)
+                return Value(std::move(copy));
+        }
+        return *this;
+    }
+
+    // --------------------------
+
     std::vector<Value>& Value::list()
     {
-        return std::get<std::vector<Value>>(m_value);
+        return unshare<internal::ListStorage>().mutableVector();
     }
 
     internal::Closure& Value::refClosure()
     {
-        return std::get<internal::Closure>(m_value);
+        return boxed<internal::Closure>();
     }
 
     String& Value::stringRef()
     {
-        return std::get<String>(m_value);
+        // the string won't match its hash once modified, even if it isn't shared anymore
+        String& str = unshare<String>();
+        payloadAs<internal::ValueBox<String>>()->hash = 0;
+        return str;
     }
 
     UserType& Value::usertypeRef()
     {
-        return std::get<UserType>(m_value);
-    }
-
-    Value* Value::reference() const
-    {
-        return std::get<Value*>(m_value);
+        return boxed<UserType>();
     }
 
     // --------------------------
 
     void Value::push_back(const Value& value)
     {
-        list().push_back(value);
+        // copy first, the value may be this list
+        Value copy(value);
+        push_back(std::move(copy));
     }
 
     void Value::push_back(Value&& value)
     {
-        list().push_back(value);
+        internal::ListStorage& storage = unshareList();
+        if (storage.persistent())
+            storage.mutableTree().push_back(std::move(value));
+        else
+            storage.mutableVector().push_back(std::move(value));
+    }
+
+    void Value::setAt(std::size_t i, Value&& value)
+    {
+        internal::ListStorage& storage = unshareList();
+        if (storage.persistent())
+            storage.mutableTree().set(i, std::move(value));
+        else
+            storage.mutableVector()[i] = std::move(value);
+    }
+
+    void Value::erase(std::size_t i)
+    {
+        internal::ListStorage& storage = unshareList();
+        if (i + 1 == storage.size())
+        {
+            if (storage.persistent())
+                storage.mutableTree().pop_back();
+            else
+                storage.mutableVector().pop_back();
+        }
+        // removing the first element of a std::vector moves all the other ones
+        else if (i == 0 && (storage.persistent() || storage.size() >= ArkPersistentListThreshold))
+            storage.mutableTree().pop_front();
+        else
+        {
+            std::vector<Value>& content = storage.mutableVector();
+            content.erase(content.begin() + i);
+        }
     }
 
     // --------------------------
@@ -175,13 +329,14 @@ namespace Ark
             case ValueType::List:
             {
                 os << "[";
-                for (auto it = V.constList().begin(), it_end = V.constList().end(); it != it_end; ++it)
+                const internal::ListStorage& list = V.constList();
+                for (std::size_t i = 0, size = list.size(); i < size; ++i)
                 {
-                    if (it->valueType() == ValueType::String)
-                        os << "\"" << (*it) << "\"";
+                    if (list[i].valueType() == ValueType::String)
+                        os << "\"" << list[i] << "\"";
                     else
-                        os << (*it);
-                    if (it + 1 != it_end)
+                        os << list[i];
+                    if (i + 1 != size)
                         os << " ";
                 }
                 os << "]";
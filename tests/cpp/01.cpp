@@ -33,5 +33,38 @@ int main()
     std::cout << value << "\n";  // displays 13
     CHECK_VALUE_NUMBER(value, 13.0)
 
+    // the state keeps an index of the symbols used by the bytecode
+    if (!state.symbolId("foo") || state.symbolId("bar"))
+    {
+        std::cerr << "the symbols index doesn't match the code\n";
+        return 1;
+    }
+
+    // the state can be given new code, even of the same size, the virtual machines running it next time
+    state.reset();
+    state.doString("(let foo (fun (x y) (- x y 2)))");
+    CHECK_VM_RUN(vm)
+    value = vm.call("foo", 5, 6.0);
+    CHECK_VALUE_NUMBER(value, -3.0)
+
+    // numbers given with their type are converted to double, whatever their C++ type
+    Ark::Value five(Ark::ValueType::Number, 5);
+    CHECK_VALUE_NUMBER(five, 5.0)
+
+    // strings and lists given with their type are stored the same way as with their own constructor
+    std::string hello = "hello";
+    Ark::Value str(Ark::ValueType::String, hello);
+    std::vector<Ark::Value> content = { five, str };
+    Ark::Value list(Ark::ValueType::List, content);
+    Ark::Value moved(Ark::ValueType::List, std::move(content));
+    if (str.valueType() != Ark::ValueType::String || str.string().toString() != "hello" ||
+        list.valueType() != Ark::ValueType::List || list.constList().size() != 2 || list != moved ||
+        list.constList()[1].string().toString() != "hello")
+    {
+        std::cerr << "typed construction of a string or a list doesn't match its content\n";
+        return 1;
+    }
+    CHECK_VALUE_NUMBER(list.constList()[0], 5.0)
+
     RETURN_PASSED()
 }
@@ -0,0 +1,52 @@
+#include <iostream>
+#include <array>
+#include <tuple>
+#include <vector>
+
+#include <Ark/Ark.hpp>
+
+#include "Tests.hpp"
+
+int main()
+{
+    Ark::State state;
+
+    // this recursion is too deep for the default stack size, each call keeping its return address and argument on the stack
+    state.doString("(let sum (fun (n) (if (= n 0) 0 (+ n (sum (- n 1)))))) (let total (sum 50000))");
+
+    // only the part of the stack actually used by the VM is allocated
+    Ark::VM vm(&state, 1 << 20);
+    CHECK_VM_RUN(vm)
+
+    auto total = vm["total"];
+    CHECK_VALUE_NUMBER(total, 1250025000)
+
+    // a small stack raises errors instead of crashing, and the VM can still be used
+    Ark::State small_state;
+    small_state.doString("(let sum (fun (n) (if (= n 0) 0 (+ n (sum (- n 1)))))) (let first (fun (a) { a }))");
+
+    Ark::VM small(&small_state, 64);
+    CHECK_VM_RUN(small)
+
+    std::vector<std::tuple<int>> depths = { { 10 }, { 1000 } };
+    auto sums = small.callBatch(small.function("sum"), depths);
+    CHECK_VALUE_NUMBER(sums[0].value, 55)
+    if (sums[1].ok() || sums[1].error->find("Maximum recursion depth exceeded") != 0)
+    {
+        std::cerr << "the recursion didn't stop on a full stack\n";
+        return 1;
+    }
+
+    std::vector<std::array<double, 100>> too_many_arguments(1);
+    auto firsts = small.callBatch(small.function("first"), too_many_arguments);
+    if (firsts[0].ok() || firsts[0].error->find("Stack overflow: more than 64 values") != 0)
+    {
+        std::cerr << "the arguments didn't overflow the stack\n";
+        return 1;
+    }
+
+    auto after = small.call("sum", 3);
+    CHECK_VALUE_NUMBER(after, 6)
+
+    RETURN_PASSED()
+}
@@ -0,0 +1,55 @@
+#include <iostream>
+
+#include <Ark/Ark.hpp>
+
+#include "Tests.hpp"
+
+int main()
+{
+    Ark::State state;
+
+    // each object is a closure stored in its own environment, a reference cycle
+    state.doString(
+        "(let make (fun (n) {"
+        "    (mut self nil)"
+        "    (let set-self (fun (x) (set self x)))"
+        "    (let obj (fun (&n &self &set-self) ()))"
+        "    (obj.set-self obj)"
+        "    obj }))"
+        "(let kept (make 42))"
+        "(mut i 0)"
+        "(mut last nil)"
+        "(while (< i 100) {"
+        "    (set last (make i))"
+        "    (set i (+ 1 i)) })"
+        "(let n kept.n)"
+        // an object removed from a big list (shared, thus persistent) isn't kept alive by the list
+        "(mut big (list:fill 70 0))"
+        "(let copy big)"
+        "(set big (append big (make 7)))"
+        "(pop! big 70)");
+
+    Ark::VM vm(&state);
+    vm.setGCThreshold(10);
+    CHECK_VM_RUN(vm)
+
+    // the collections ran while the objects were created, each one freeing the environments of the discarded objects
+    if (vm.gcStats().collections == 0 || vm.gcStats().freed == 0)
+    {
+        std::cerr << "no environment was collected\n";
+        return 1;
+    }
+
+    // the last ones are freed now, the ones referenced by global variables stay alive
+    vm.collectGarbage();
+    if (vm.gcStats().tracked != 2)
+    {
+        std::cerr << vm.gcStats().tracked << " environments are alive instead of 2\n";
+        return 1;
+    }
+
+    auto n = vm["n"];
+    CHECK_VALUE_NUMBER(n, 42)
+
+    RETURN_PASSED()
+}
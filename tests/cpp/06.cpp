@@ -0,0 +1,92 @@
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <string>
+
+#include <Ark/Ark.hpp>
+
+#include "Tests.hpp"
+
+// Run the same program in many virtual machines, on many threads, sharing one State.
+
+constexpr int CallsPerThread = 40;
+
+/**
+ * @brief Run the program on a number of threads, each one having its own VM
+ *
+ * @param state
+ * @param threads
+ * @return int number of failed calls
+ */
+int runThreads(Ark::State& state, unsigned threads)
+{
+    std::atomic<int> failures = 0;
+    std::vector<std::thread> workers;
+
+    for (unsigned t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&state, &failures]() {
+            Ark::VM vm(&state);
+            if (vm.run() != 0)
+            {
+                ++failures;
+                return;
+            }
+
+            for (int i = 0; i < CallsPerThread; ++i)
+            {
+                if (Ark::Value fib = vm.call("fib", 18); fib.valueType() != Ark::ValueType::Number || fib.number() != 2584)
+                    ++failures;
+                // modifying a copy of a constant must not modify the constant
+                if (Ark::Value greeting = vm.call("greet", std::string("world")); greeting.valueType() != Ark::ValueType::String || std::string(greeting.string().c_str()) != "hello world!")
+                    ++failures;
+            }
+        });
+    }
+
+    for (std::thread& worker : workers)
+        worker.join();
+    return failures;
+}
+
+int main()
+{
+    Ark::State state;
+
+    state.doString(
+        "(let fib (fun (n) (if (< n 2) n (+ (fib (- n 1)) (fib (- n 2))))))"
+        "(let greet (fun (name) {"
+        "    (mut text \"hello \")"
+        "    (set text (+ text name))"
+        "    (set text (+ text \"!\"))"
+        "    (if (= name \"world\") text \"\") }))");
+
+    unsigned max_threads = std::max(4u, std::thread::hardware_concurrency());
+
+    if (int failures = runThreads(state, max_threads); failures != 0)
+    {
+        std::cerr << failures << " calls failed\n";
+        return 1;
+    }
+
+    // the interned strings given to the host outlive their State
+    Ark::Value constant, names, title;
+    {
+        Ark::State scoped;
+        scoped.doString("(let title \"constant\") (let name (fun () { title })) (let names (fun () { (list 1 \"constant\") }))");
+        Ark::VM vm(&scoped);
+        CHECK_VM_RUN(vm)
+        constant = vm.call("name");
+        names = vm.call("names");
+        title = vm["title"];
+    }
+    if (constant.valueType() != Ark::ValueType::String || std::string(constant.string().c_str()) != "constant" ||
+        names.valueType() != Ark::ValueType::List || names.constList()[1] != constant || title != constant)
+    {
+        std::cerr << "the interned string didn't outlive its State\n";
+        return 1;
+    }
+
+    RETURN_PASSED()
+}
@@ -0,0 +1,59 @@
+#include <iostream>
+
+#include <Ark/Ark.hpp>
+
+#include "Tests.hpp"
+
+// Clone a VM after it ran its program, and check that the clones don't share their variables.
+
+int main()
+{
+    Ark::State state;
+
+    state.doString(
+        "(let make-counter (fun () {"
+        "    (mut count 0)"
+        "    (fun (&count) {"
+        "        (set count (+ 1 count))"
+        "        count }) }))"
+        "(let counter (make-counter))"
+        "(let counters [(make-counter) (make-counter)])"
+        "(mut table [])"
+        "(mut i 0)"
+        "(while (< i 100) {"
+        "    (set table (append table (* i i)))"
+        "    (set i (+ 1 i)) })"
+        "(let increment (fun () (counter)))"
+        "(let increment-second (fun () ((@ counters 1))))"
+        "(let square (fun (n) (@ table n)))");
+
+    Ark::VM vm(&state);
+    CHECK_VM_RUN(vm)
+
+    auto increment = vm.call("increment");
+    CHECK_VALUE_NUMBER(increment, 1)
+
+    Ark::VM first(vm);
+    Ark::VM second(vm);
+
+    // each clone starts from the state of the original VM, and modifies its own copy of the closures environments
+    auto a = first.call("increment");
+    CHECK_VALUE_NUMBER(a, 2)
+    auto b = first.call("increment");
+    CHECK_VALUE_NUMBER(b, 3)
+    auto c = second.call("increment");
+    CHECK_VALUE_NUMBER(c, 2)
+    auto d = vm.call("increment");
+    CHECK_VALUE_NUMBER(d, 2)
+
+    // including the ones held in lists
+    auto e = first.call("increment-second");
+    CHECK_VALUE_NUMBER(e, 1)
+    auto f = second.call("increment-second");
+    CHECK_VALUE_NUMBER(f, 1)
+
+    auto square = second.call("square", 12);
+    CHECK_VALUE_NUMBER(square, 144)
+
+    RETURN_PASSED()
+}
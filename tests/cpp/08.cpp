@@ -0,0 +1,55 @@
+#include <iostream>
+
+#include <Ark/Ark.hpp>
+
+#include "Tests.hpp"
+
+// Call ArkScript functions through handles.
+
+int main()
+{
+    Ark::State state;
+
+    state.doString(
+        "(let add (fun (a b) (+ a b)))"
+        "(let make-adder (fun (n) (fun (x &n) (+ x n))))"
+        "(let add3 (make-adder 3))"
+        "(let forty-two (fun () (+ 40 2)))"
+        "(let not-a-function 12)");
+
+    Ark::VM vm(&state);
+    CHECK_VM_RUN(vm)
+
+    Ark::FunctionHandle add = vm.function("add");
+    auto sum = vm.call(add, 1, 2);
+    CHECK_VALUE_NUMBER(sum, 3)
+
+    Ark::FunctionHandle add3 = vm.function("add3");
+    auto sum3 = vm.call(add3, 4);
+    CHECK_VALUE_NUMBER(sum3, 7)
+
+    auto answer = vm.call(vm.function("forty-two"));
+    CHECK_VALUE_NUMBER(answer, 42)
+
+    try
+    {
+        vm.function("not-a-function");
+        std::cerr << "not-a-function was found as a function\n";
+        return 1;
+    }
+    catch (const std::exception&)
+    {}
+
+    // the handles belong to the VM which gave them
+    Ark::VM clone(vm);
+    try
+    {
+        clone.call(add, 1, 2);
+        std::cerr << "a handle of another VM was used\n";
+        return 1;
+    }
+    catch (const std::exception&)
+    {}
+
+    RETURN_PASSED()
+}
@@ -0,0 +1,58 @@
+#include <iostream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <Ark/Ark.hpp>
+
+#include "Tests.hpp"
+
+// Call an ArkScript function over many sets of arguments with VM::callBatch, some of the calls failing.
+
+int main()
+{
+    Ark::State state;
+
+    state.doString(
+        "(let weight 2)"
+        "(let check (fun (x) (if (< x 0) (+ x \"negative\") x)))"
+        "(let make-scorer (fun (bonus) (fun (x y &bonus) (+ (* weight (check x)) y bonus))))"
+        "(let score (make-scorer 1))");
+
+    Ark::VM vm(&state);
+    CHECK_VM_RUN(vm)
+
+    std::vector<std::tuple<double, double>> records = { { 1, 2 }, { -1, 2 }, { 3, 4 }, { -5, 0 }, { 10, 0 } };
+    std::vector<Ark::CallResult> results = vm.callBatch(vm.function("score"), records);
+
+    if (results.size() != records.size())
+    {
+        std::cerr << "got " << results.size() << " results for " << records.size() << " calls\n";
+        return 1;
+    }
+
+    // the errors are raised two calls deep, in a closure, and don't stop the other calls
+    const double expected[] = { 5, 0, 11, 0, 21 };
+    for (std::size_t i = 0; i < results.size(); ++i)
+    {
+        bool should_fail = std::get<0>(records[i]) < 0;
+        if (results[i].ok() == should_fail)
+        {
+            std::cerr << "call " << i << (should_fail ? " should have failed\n" : " failed\n");
+            return 1;
+        }
+        if (!should_fail)
+            CHECK_VALUE_NUMBER(results[i].value, expected[i])
+    }
+    if (results[1].error->find("+: needs 2 argument(s)") != 0)
+    {
+        std::cerr << "unexpected error message: " << *results[1].error << "\n";
+        return 1;
+    }
+
+    // the VM is still usable
+    auto after = vm.call("score", 0, 0);
+    CHECK_VALUE_NUMBER(after, 1)
+
+    RETURN_PASSED()
+}
@@ -0,0 +1,127 @@
+#include <iostream>
+#include <cmath>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <Ark/Ark.hpp>
+
+#include "Tests.hpp"
+
+// Bind ordinary C++ functions with State::bind, and check the conversions and the errors of the generated wrappers.
+
+double distance(double x, double y)
+{
+    return std::sqrt(x * x + y * y);
+}
+
+std::string repeat(const std::string& text, int count)
+{
+    std::string result;
+    for (int i = 0; i < count; ++i)
+        result += text;
+    return result;
+}
+
+std::size_t length(std::string_view text) noexcept
+{
+    return text.size();
+}
+
+bool isLong(const std::vector<Ark::Value>& list, bool strict)
+{
+    return strict ? list.size() > 3 : list.size() >= 3;
+}
+
+int called = 0;
+
+void touch(Ark::VM* vm)
+{
+    if (vm != nullptr)
+        ++called;
+}
+
+int main()
+{
+    Ark::State state;
+    state.bind<&distance>("distance");
+    state.bind<&repeat>("repeat");
+    state.bind<&length>("length");
+    state.bind<&isLong>("long?");
+    state.bind<&touch>("touch");
+
+    state.doString(
+        "(let d (distance 3 4))"
+        "(let r (repeat \"ab\" 3))"
+        "(let l (length r))"
+        "(let big (long? [1 2 3] true))"
+        "(let small (long? [1 2 3] false))"
+        "(let t (touch))");
+
+    Ark::VM vm(&state);
+    CHECK_VM_RUN(vm)
+
+    CHECK_VALUE_NUMBER(vm["d"], 5)
+    if (vm["r"].valueType() != Ark::ValueType::String || vm["r"].string().toString() != "ababab")
+    {
+        std::cerr << "r isn't the String \"ababab\"\n";
+        return 1;
+    }
+    CHECK_VALUE_NUMBER(vm["l"], 6)
+    if (vm["big"].valueType() != Ark::ValueType::False || vm["small"].valueType() != Ark::ValueType::True)
+    {
+        std::cerr << "long? gave a wrong result\n";
+        return 1;
+    }
+    if (vm["t"].valueType() != Ark::ValueType::Nil || called != 1)
+    {
+        std::cerr << "touch wasn't given the VM, or didn't return nil\n";
+        return 1;
+    }
+
+    // the generated wrappers check the number and types of the arguments
+    std::vector<Ark::Value> wrong_type = { Ark::Value(1.0), Ark::Value("2") };
+    std::vector<Ark::Value> wrong_arity = { Ark::Value(1.0) };
+    for (auto* args : { &wrong_type, &wrong_arity })
+    {
+        try
+        {
+            Ark::internal::Binding<&distance>::call(Ark::ArgsView(args->data(), args->size()), &vm);
+            std::cerr << "distance accepted wrong arguments\n";
+            return 1;
+        }
+        catch (const Ark::BetterTypeError& e)
+        {
+            std::string expected = args == &wrong_type ? "distance: needs 2 argument(s), got 2\n  -> arg1 (Number) was of type Number\n  -> arg2 (Number) was of type String"
+                                                       : "distance: needs 2 argument(s), but got 1\n  -> arg1 (Number) was of type Number\n  -> arg2 (Number) was not provided";
+            if (e.what() != expected)
+            {
+                std::cerr << "unexpected error message: " << e.what() << "\n";
+                return 1;
+            }
+        }
+    }
+
+    // integers only receive integral numbers in their range, instead of truncating them
+    std::vector<Ark::Value> not_integral = { Ark::Value("ab"), Ark::Value(2.5) };
+    std::vector<Ark::Value> out_of_range = { Ark::Value("ab"), Ark::Value(1e20) };
+    for (auto* args : { &not_integral, &out_of_range })
+    {
+        try
+        {
+            Ark::internal::Binding<&repeat>::call(Ark::ArgsView(args->data(), args->size()), &vm);
+            std::cerr << "repeat accepted " << (*args)[1].number() << " as an int\n";
+            return 1;
+        }
+        catch (const Ark::BetterTypeError& e)
+        {
+            if (std::string(e.what()) != "repeat: needs 2 argument(s), got 2\n  -> arg1 (String) was of type String\n  -> arg2 (Number) was of type Number")
+            {
+                std::cerr << "unexpected error message: " << e.what() << "\n";
+                return 1;
+            }
+        }
+    }
+
+    RETURN_PASSED()
+}
@@ -0,0 +1,84 @@
+#include <iostream>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include <Ark/Ark.hpp>
+
+#include "Tests.hpp"
+
+// Run programs with a budget of instructions (VM::runFor) or a deadline (VM::runUntil), interleaving them on one thread,
+// and stop a program which never ends.
+
+int main()
+{
+    Ark::State state;
+
+    state.doString(
+        "(let fibo (fun (n) (if (< n 2) n (+ (fibo (- n 1)) (fibo (- n 2))))))"
+        "(mut total 0)"
+        "(mut i 0)"
+        "(while (< i 1000) {"
+        "    (set total (+ total i))"
+        "    (set i (+ 1 i)) })"
+        "(let result (+ total (fibo 15)))");
+
+    // round robin between VMs running the same program, on one thread
+    std::vector<std::unique_ptr<Ark::VM>> vms;
+    for (int i = 0; i < 10; ++i)
+        vms.push_back(std::make_unique<Ark::VM>(&state));
+
+    std::vector<Ark::ExecutionStatus> statuses(vms.size(), Ark::ExecutionStatus::Yielded);
+    std::size_t running = vms.size();
+    std::size_t slices = 0;
+    while (running > 0)
+    {
+        for (std::size_t i = 0; i < vms.size(); ++i)
+        {
+            if (statuses[i] != Ark::ExecutionStatus::Yielded)
+                continue;
+            statuses[i] = vms[i]->runFor(500);
+            ++slices;
+            if (statuses[i] != Ark::ExecutionStatus::Yielded)
+                --running;
+        }
+    }
+
+    for (std::size_t i = 0; i < vms.size(); ++i)
+    {
+        if (statuses[i] != Ark::ExecutionStatus::Finished)
+        {
+            std::cerr << "vm " << i << " didn't finish\n";
+            return 1;
+        }
+        CHECK_VALUE_NUMBER((*vms[i])["result"], 499500 + 610)
+    }
+    if (slices < 10 * vms.size())
+    {
+        std::cerr << "the programs were only suspended " << slices << " times\n";
+        return 1;
+    }
+
+    // a program which never ends can be stopped, and the VM reused
+    Ark::State endless;
+    endless.doString(
+        "(mut n 0)"
+        "(while true (set n (+ 1 n)))");
+
+    Ark::VM vm(&endless);
+    auto status = vm.runUntil(std::chrono::steady_clock::now() + std::chrono::milliseconds(20));
+    if (status != Ark::ExecutionStatus::Yielded || vm["n"].number() == 0)
+    {
+        std::cerr << "the endless program wasn't suspended\n";
+        return 1;
+    }
+    double before = vm["n"].number();
+    vm.runFor(1000);
+    if (vm["n"].number() <= before)
+    {
+        std::cerr << "the endless program wasn't resumed\n";
+        return 1;
+    }
+
+    RETURN_PASSED()
+}
@@ -0,0 +1,135 @@
+#include <iostream>
+#include <deque>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <Ark/Ark.hpp>
+
+#include "Tests.hpp"
+
+// Drive many programs from an event loop on one thread, each of them waiting for the results of an asynchronous
+// C++ function which suspends it (VM::suspend) instead of blocking, the results being given back with VM::resume.
+
+struct Request
+{
+    Ark::VM* vm;
+    double argument;
+};
+
+std::deque<Request> requests;
+
+Ark::Value fetch(Ark::ArgsView args, Ark::VM* vm)
+{
+    if (args.size() != 1 || args[0].valueType() != Ark::ValueType::Number)
+        throw Ark::BetterTypeError("fetch", 1, args.toVector()).withArg("key", Ark::ValueType::Number);
+
+    Ark::Value placeholder = vm->suspend();
+    requests.push_back(Request { vm, args[0].number() });
+    return placeholder;
+}
+
+Ark::Value applyTo(Ark::ArgsView args, Ark::VM* vm)
+{
+    return vm->resolve(&args[0], args[1]);
+}
+
+int main()
+{
+    Ark::State state;
+    state.loadFunction("fetch", &fetch);
+    state.loadFunction("apply-to", &applyTo);
+
+    state.doString(
+        "(let double-fetch (fun (key) (* 2 (fetch key))))"
+        "(mut total 0)"
+        "(mut i 0)"
+        "(while (< i 3) {"
+        "    (set total (+ total (double-fetch i)))"
+        "    (set i (+ 1 i)) })"
+        "(let result (+ total (fetch 10)))");
+
+    std::vector<std::unique_ptr<Ark::VM>> vms;
+    for (int i = 0; i < 20; ++i)
+        vms.push_back(std::make_unique<Ark::VM>(&state));
+
+    for (auto& vm : vms)
+    {
+        if (vm->runFor(1000) != Ark::ExecutionStatus::Suspended || !vm->suspended())
+        {
+            std::cerr << "the program wasn't suspended by fetch\n";
+            return 1;
+        }
+    }
+
+    // the event loop: each request is answered later, with key * 100, interleaving the programs
+    std::size_t finished = 0;
+    std::size_t answered = 0;
+    while (!requests.empty())
+    {
+        Request request = requests.front();
+        requests.pop_front();
+        ++answered;
+
+        Ark::ExecutionStatus status = request.vm->resume(Ark::Value(request.argument * 100), 1000);
+        while (status == Ark::ExecutionStatus::Yielded)
+            status = request.vm->runFor(1000);
+
+        if (status == Ark::ExecutionStatus::Failed)
+        {
+            std::cerr << "a program failed\n";
+            return 1;
+        }
+        if (status == Ark::ExecutionStatus::Finished)
+            ++finished;
+    }
+
+    if (finished != vms.size() || answered != 4 * vms.size())
+    {
+        std::cerr << finished << " programs finished, " << answered << " requests answered\n";
+        return 1;
+    }
+    for (auto& vm : vms)
+        CHECK_VALUE_NUMBER((*vm)["result"], 2 * (0 + 100 + 200) + 1000)
+
+    // the program continues after a function called from C++, which can't be suspended
+    Ark::State nested;
+    nested.loadFunction("fetch", &fetch);
+    nested.loadFunction("apply-to", &applyTo);
+    nested.doString(
+        "(mut after 0)"
+        "(let g (fun (x) (apply-to (fun (y) (+ y 1)) x)))"
+        "(let f (fun () (g 1)))"
+        "(let r (f))"
+        "(set after r)"
+        "(let wait (fun () (fetch 1)))");
+
+    Ark::VM vm(&nested);
+    if (vm.runFor(1000) != Ark::ExecutionStatus::Finished)
+    {
+        std::cerr << "the nested program didn't finish\n";
+        return 1;
+    }
+    CHECK_VALUE_NUMBER(vm["after"], 2)
+
+    std::vector<std::tuple<>> one_call(1);
+    auto results = vm.callBatch(vm.function("wait"), one_call);
+    if (results[0].ok() || results[0].error->find("can not suspend the program") != 0 || !requests.empty())
+    {
+        std::cerr << "a function called from C++ was suspended\n";
+        return 1;
+    }
+
+    try
+    {
+        vm.resume(Ark::Value(1.0));
+        std::cerr << "a program which wasn't suspended was resumed\n";
+        return 1;
+    }
+    catch (const std::exception&)
+    {}
+
+    RETURN_PASSED()
+}
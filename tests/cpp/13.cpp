@@ -0,0 +1,80 @@
+#include <iostream>
+#include <vector>
+
+#include <Ark/Ark.hpp>
+
+#include "Tests.hpp"
+
+// C++ functions receiving their arguments as a view on the stack (Ark::ArgsView), next to functions using the
+// old signature, which are given a copy of their arguments.
+
+Ark::Value sum(Ark::ArgsView args, Ark::VM* vm [[maybe_unused]])
+{
+    double total = 0;
+    for (std::size_t i = 0; i < args.size(); ++i)
+    {
+        if (args[i].valueType() != Ark::ValueType::Number)
+            throw Ark::BetterTypeError("sum", 1, args.toVector()).withArg("number", Ark::ValueType::Number);
+        total += args[i].number();
+    }
+    return Ark::Value(total);
+}
+
+// the list is modified in place if it is a temporary, and copied if it belongs to a variable
+Ark::Value pushOne(Ark::ArgsView args, Ark::VM* vm [[maybe_unused]])
+{
+    Ark::Value list = args.take(0);
+    list.push_back(Ark::Value(1));
+    return list;
+}
+
+Ark::Value pushOneLegacy(std::vector<Ark::Value>& args, Ark::VM* vm [[maybe_unused]])
+{
+    args[0].push_back(Ark::Value(1));
+    return args[0];
+}
+
+int main()
+{
+    Ark::State state;
+    state.loadFunction("sum", &sum);
+    state.loadFunction("push-one", &pushOne);
+    state.loadFunction("push-one-legacy", &pushOneLegacy);
+
+    state.doString(
+        "(let s (sum 1 2 3 4))"
+        "(let empty (sum))"
+        "(let l [0])"
+        "(let a (push-one l))"
+        "(let b (push-one-legacy l))"
+        "(let c (push-one [5 6]))"
+        "(let d (push-one-legacy (push-one [])))");
+
+    Ark::VM vm(&state);
+    CHECK_VM_RUN(vm)
+
+    CHECK_VALUE_NUMBER(vm["s"], 10)
+    CHECK_VALUE_NUMBER(vm["empty"], 0)
+
+    if (vm["l"].constList().size() != 1 || vm["a"].constList().size() != 2 || vm["b"].constList().size() != 2)
+    {
+        std::cerr << "a variable given to a C++ function was modified\n";
+        return 1;
+    }
+    if (vm["c"].constList().size() != 3 || vm["d"].constList().size() != 2)
+    {
+        std::cerr << "a temporary list wasn't modified\n";
+        return 1;
+    }
+
+    // both kinds of functions are kept in the value, without any limit on their number
+    Ark::Value legacy(&pushOneLegacy);
+    Ark::Value current(&pushOne);
+    if (legacy.valueType() != Ark::ValueType::CProc || current.valueType() != Ark::ValueType::CProc || legacy == current)
+    {
+        std::cerr << "C++ functions weren't stored as CProc\n";
+        return 1;
+    }
+
+    RETURN_PASSED()
+}
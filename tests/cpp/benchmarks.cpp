@@ -0,0 +1,298 @@
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include <Ark/Ark.hpp>
+
+// Benchmarks of the embedding API, compared with what they replace. They are built with the integration tests
+// but not run by run-tests: launch `out/benchmarks` to run all of them, or `out/benchmarks <name>` to run one.
+
+namespace
+{
+    double distance(double x, double y)
+    {
+        return std::sqrt(x * x + y * y);
+    }
+
+    Ark::Value distanceByHand(Ark::ArgsView args, Ark::VM*)
+    {
+        if (args.size() != 2 || args[0].valueType() != Ark::ValueType::Number || args[1].valueType() != Ark::ValueType::Number)
+            throw Ark::BetterTypeError("distance-by-hand", 2, args.toVector())
+                .withArg("x", Ark::ValueType::Number)
+                .withArg("y", Ark::ValueType::Number);
+        return Ark::Value(distance(args[0].number(), args[1].number()));
+    }
+
+    /**
+     * @brief Calls per second of one program running in a VM per thread, all sharing the same State, for 1 to N threads
+     *
+     */
+    void threads()
+    {
+        constexpr int CallsPerThread = 40;
+
+        Ark::State state;
+        state.doString(
+            "(let fib (fun (n) (if (< n 2) n (+ (fib (- n 1)) (fib (- n 2))))))"
+            "(let greet (fun (name) {"
+            "    (mut text \"hello \")"
+            "    (set text (+ text name))"
+            "    (set text (+ text \"!\"))"
+            "    (if (= name \"world\") text \"\") }))");
+
+        unsigned max_threads = std::max(4u, std::thread::hardware_concurrency());
+        for (unsigned count = 1; count <= max_threads; count *= 2)
+        {
+            auto start = std::chrono::steady_clock::now();
+
+            std::vector<std::thread> workers;
+            for (unsigned t = 0; t < count; ++t)
+            {
+                workers.emplace_back([&state]() {
+                    Ark::VM vm(&state);
+                    vm.run();
+                    for (int i = 0; i < CallsPerThread; ++i)
+                    {
+                        vm.call("fib", 18);
+                        vm.call("greet", std::string("world"));
+                    }
+                });
+            }
+            for (std::thread& worker : workers)
+                worker.join();
+
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            std::cout << count << " threads: " << static_cast<long>(count * CallsPerThread / elapsed.count()) << " calls/s\n";
+        }
+    }
+
+    /**
+     * @brief Time needed to get a VM ready to call functions, by running the program and by cloning a VM which ran it
+     *
+     */
+    void clone()
+    {
+        constexpr int Count = 1000;
+
+        Ark::State state;
+        state.doString(
+            "(let make-counter (fun () {"
+            "    (mut count 0)"
+            "    (fun (&count) {"
+            "        (set count (+ 1 count))"
+            "        count }) }))"
+            "(let counter (make-counter))"
+            "(mut table [])"
+            "(mut i 0)"
+            "(while (< i 100) {"
+            "    (set table (append table (* i i)))"
+            "    (set i (+ 1 i)) })");
+
+        Ark::VM vm(&state);
+        vm.run();
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < Count; ++i)
+        {
+            Ark::VM fresh(&state);
+            fresh.run();
+        }
+        std::chrono::duration<double, std::micro> run_time = std::chrono::steady_clock::now() - start;
+
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < Count; ++i)
+            Ark::VM copy(vm);
+        std::chrono::duration<double, std::micro> clone_time = std::chrono::steady_clock::now() - start;
+
+        std::cout << "run:   " << run_time.count() / Count << "us per VM\n"
+                  << "clone: " << clone_time.count() / Count << "us per VM\n";
+    }
+
+    /**
+     * @brief Cost of a call by name and through a function handle
+     *
+     */
+    void handles()
+    {
+        constexpr int Count = 1000000;
+
+        Ark::State state;
+        state.doString("(let add (fun (a b) (+ a b)))");
+
+        Ark::VM vm(&state);
+        vm.run();
+        Ark::FunctionHandle add = vm.function("add");
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < Count; ++i)
+            vm.call("add", i, 1);
+        std::chrono::duration<double, std::nano> by_name = std::chrono::steady_clock::now() - start;
+
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < Count; ++i)
+            vm.call(add, i, 1);
+        std::chrono::duration<double, std::nano> by_handle = std::chrono::steady_clock::now() - start;
+
+        std::cout << "by name:   " << by_name.count() / Count << "ns per call\n"
+                  << "by handle: " << by_handle.count() / Count << "ns per call\n";
+    }
+
+    /**
+     * @brief Cost of a call made by VM::callBatch and one by one through a handle
+     *
+     */
+    void batch()
+    {
+        constexpr int Count = 1000000;
+
+        Ark::State state;
+        state.doString(
+            "(let weight 2)"
+            "(let check (fun (x) (if (< x 0) (+ x \"negative\") x)))"
+            "(let make-scorer (fun (bonus) (fun (x y &bonus) (+ (* weight (check x)) y bonus))))"
+            "(let score (make-scorer 1))");
+
+        Ark::VM vm(&state);
+        vm.run();
+        Ark::FunctionHandle score = vm.function("score");
+
+        std::vector<std::tuple<int, int>> many;
+        many.reserve(Count);
+        for (int i = 0; i < Count; ++i)
+            many.emplace_back(i, 1);
+
+        std::vector<Ark::Value> values;
+        values.reserve(Count);
+
+        auto start = std::chrono::steady_clock::now();
+        for (const auto& [x, y] : many)
+            values.push_back(vm.call(score, x, y));
+        std::chrono::duration<double, std::nano> one_by_one = std::chrono::steady_clock::now() - start;
+
+        start = std::chrono::steady_clock::now();
+        vm.callBatch(score, many);
+        std::chrono::duration<double, std::nano> batch = std::chrono::steady_clock::now() - start;
+
+        std::cout << "one by one: " << one_by_one.count() / Count << "ns per call\n"
+                  << "batch:      " << batch.count() / Count << "ns per call\n";
+    }
+
+    /**
+     * @brief Cost of a call to a function bound with State::bind, and to the same function written by hand
+     *
+     */
+    void binding()
+    {
+        constexpr int Count = 1000;
+
+        Ark::State state;
+        state.bind<&distance>("distance");
+        state.loadFunction("distance-by-hand", &distanceByHand);
+        state.doString(
+            "(let loop-bound (fun () {"
+            "    (mut i 0)"
+            "    (while (< i 1000) {"
+            "        (distance i 2)"
+            "        (set i (+ 1 i)) }) }))"
+            "(let loop-by-hand (fun () {"
+            "    (mut i 0)"
+            "    (while (< i 1000) {"
+            "        (distance-by-hand i 2)"
+            "        (set i (+ 1 i)) }) }))");
+
+        Ark::VM vm(&state);
+        vm.run();
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < Count; ++i)
+            vm.call("loop-bound");
+        std::chrono::duration<double, std::nano> bound = std::chrono::steady_clock::now() - start;
+
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < Count; ++i)
+            vm.call("loop-by-hand");
+        std::chrono::duration<double, std::nano> by_hand = std::chrono::steady_clock::now() - start;
+
+        std::cout << "bound:   " << bound.count() / (Count * 1000) << "ns per iteration\n"
+                  << "by hand: " << by_hand.count() / (Count * 1000) << "ns per iteration\n";
+    }
+
+    /**
+     * @brief Time needed to run a program at once with VM::run, and by slices of 10000 instructions with VM::runFor
+     *
+     */
+    void slices()
+    {
+        constexpr int Count = 100;
+
+        Ark::State state;
+        state.doString(
+            "(let fibo (fun (n) (if (< n 2) n (+ (fibo (- n 1)) (fibo (- n 2))))))"
+            "(mut total 0)"
+            "(mut i 0)"
+            "(while (< i 1000) {"
+            "    (set total (+ total i))"
+            "    (set i (+ 1 i)) })"
+            "(let result (+ total (fibo 15)))");
+
+        Ark::VM vm(&state);
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < Count; ++i)
+            vm.run();
+        std::chrono::duration<double, std::micro> run_time = std::chrono::steady_clock::now() - start;
+
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < Count; ++i)
+        {
+            while (vm.runFor(10000) == Ark::ExecutionStatus::Yielded)
+                ;
+        }
+        std::chrono::duration<double, std::micro> sliced_time = std::chrono::steady_clock::now() - start;
+
+        std::cout << "run:              " << run_time.count() / Count << "us per program\n"
+                  << "runFor by 10000:  " << sliced_time.count() / Count << "us per program\n";
+    }
+
+    struct Benchmark
+    {
+        const char* name;
+        void (*run)();
+    };
+
+    const Benchmark benchmarks[] = {
+        { "threads", &threads },
+        { "clone", &clone },
+        { "handles", &handles },
+        { "batch", &batch },
+        { "binding", &binding },
+        { "slices", &slices },
+    };
+}
+
+int main(int argc, char** argv)
+{
+    bool found = false;
+    for (const Benchmark& benchmark : benchmarks)
+    {
+        if (argc > 1 && std::string(argv[1]) != benchmark.name)
+            continue;
+
+        found = true;
+        std::cout << "== " << benchmark.name << "\n";
+        benchmark.run();
+    }
+
+    if (!found)
+    {
+        std::cerr << "unknown benchmark: " << argv[1] << "\n";
+        return 1;
+    }
+    return 0;
+}